@@ -0,0 +1,55 @@
+#ifndef ALLOCATION_TRACKER_HPP
+#define ALLOCATION_TRACKER_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+
+enum class AllocPhase
+{
+	EVENTS, TICK, RENDER, OTHER, COUNT
+};
+
+struct AllocCounts
+{
+	std::uint64_t allocations = 0;
+	std::uint64_t bytes = 0;
+	std::uint64_t frees = 0;
+	std::uint64_t surfaces = 0;
+	std::uint64_t textures = 0;
+};
+
+// Counts heap allocations made by the game loop's thread through the global operator new, plus SDL surfaces and
+// textures created through the wrappers below, per loop phase of the current frame.
+class AllocationTracker
+{
+private:
+	static AllocPhase phase_;
+	static AllocCounts frame_[static_cast<int>(AllocPhase::COUNT)];
+
+public:
+	static void Enable();
+
+	static bool Enabled();
+
+	static void SetPhase(AllocPhase phase);
+
+	static void CountAllocation(std::size_t bytes);
+
+	static void CountFree();
+
+	static SDL_Surface* CountSurface(SDL_Surface* surface);
+
+	static SDL_Texture* CountTexture(SDL_Texture* texture);
+
+	static const AllocCounts& Frame(AllocPhase phase);
+
+	static AllocCounts FrameTotal();
+
+	static void EndFrame();
+
+	static const char* PhaseName(AllocPhase phase);
+};
+
+#endif
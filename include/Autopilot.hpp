@@ -0,0 +1,27 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include <SDL2/SDL.h>
+
+class Game;
+class Player;
+
+class Autopilot
+{
+private:
+	Game* game_;
+	bool auto_reset_;
+
+	void PressKey(SDL_Keycode key);
+
+	bool ObstacleAhead(const SDL_Rect& player_box);
+
+public:
+	Autopilot(Game* game, bool auto_reset);
+
+	~Autopilot();
+
+	void Tick(const Player& player);
+};
+
+#endif
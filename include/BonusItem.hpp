@@ -10,16 +10,20 @@ enum class BonusItemType
 	MONEY
 };
 
+inline constexpr int bonus_item_type_count = static_cast<int>(BonusItemType::MONEY) + 1;
+
 class BonusItem : public Entity
 {
 private:
 	BonusItemType type_;
 
 public:
-	BonusItem(Game* game, Texture* sprites_texture, BonusItemType type, int x, float scale);
+	BonusItem(Game* game, TextureAtlas* atlas, BonusItemType type, int x, float scale, const RandomStream& random);
 
 	~BonusItem();
 
+	void Reset(BonusItemType type, int x, const RandomStream& random);
+
 	void HandleEvent(SDL_Event* e) override;
 
 	void Tick() override;
@@ -28,7 +32,17 @@ public:
 
 	void Respawn() override;
 
+	void SaveState(EntityState& state) const override;
+
+	void LoadState(const EntityState& state) override;
+
+	const CollisionMask& Mask() const override;
+
 	void SetType(BonusItemType type);
+
+	static SDL_Rect SpriteClip(const TextureAtlas& atlas, BonusItemType type);
+
+	static CollisionMask BuildMask(const TextureAtlas& atlas, BonusItemType type, int scale);
 };
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef COLLISION_MASK_HPP
+#define COLLISION_MASK_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <vector>
+
+// One bit per opaque pixel, every row packed into 64-bit words. Rows carry one extra zero word,
+// so reading 64 bits from any column never runs past the end of the row.
+class CollisionMask
+{
+private:
+	int width_;
+	int height_;
+	int words_per_row_;
+	std::vector<std::uint64_t> rows_;
+
+	std::uint64_t Bits(int x, int y) const;
+
+public:
+	CollisionMask();
+
+	CollisionMask(int width, int height);
+
+	~CollisionMask();
+
+	int Width() const;
+
+	int Height() const;
+
+	bool Get(int x, int y) const;
+
+	void Set(int x, int y);
+
+	void Add(const CollisionMask& other, int x, int y);
+
+	CollisionMask Scaled(const SDL_Rect& area, int scale) const;
+
+	bool Overlaps(const CollisionMask& other, int dx, int dy) const;
+};
+
+#endif
@@ -6,7 +6,34 @@ namespace constants
 	inline constexpr char game_title[] = "Sidescroller"; 
 	inline constexpr int screen_width = 960;
 	inline constexpr int screen_height = 720;
-	inline constexpr float g = 1.5f;
+	inline constexpr int tick_rate = 60;
+	inline constexpr int native_scale = 2;
+	inline constexpr int player_scale = 4;
+	inline constexpr int obstacle_scale = 2;
+	inline constexpr int bonus_item_scale = 4;
+	inline constexpr int obstacle_count = 5;
+	inline constexpr int bonus_item_count = 5;
+	inline constexpr int rewind_seconds = 10;
+	inline constexpr int particle_capacity = 4096;
+	inline constexpr int alloc_warmup_frames = 120;
+	// A frame that took longer than this, in wall time, only advances the game by this much, the rest is dropped.
+	inline constexpr int max_catch_up_ms = 250;
+	// Physics is in pixels and seconds, so every tick rate plays the same game.
+	inline constexpr int gravity = 5400;
+	inline constexpr int jump_velocity = 1800;
+	inline constexpr int scrolling_speed = 600;
+	inline constexpr int scrolling_speed_step = 60;
+	inline constexpr int min_tick_rate = 30;
+	inline constexpr int max_tick_rate = 1000;
+	inline constexpr int max_scrolling_speed = 1500;
+	// Collisions are only tested at ticks. Nothing passes through the player between two ticks as long as they move
+	// relative to each other by less than their combined extents per tick: 15x35 player sprites against 32 px
+	// obstacles across and 16x8 coins vertically, the narrowest pairs, at their scales. Only the player moves
+	// vertically, by at most jump_velocity, and only the world horizontally, by at most max_scrolling_speed.
+	inline constexpr int min_collision_extent_x = 15 * player_scale + 32 * obstacle_scale;
+	inline constexpr int min_collision_extent_y = 35 * player_scale + 8 * bonus_item_scale;
+	static_assert(max_scrolling_speed < min_collision_extent_x * min_tick_rate, "obstacles could pass through the player between two ticks");
+	static_assert(jump_velocity < min_collision_extent_y * min_tick_rate, "the player could jump through a bonus item between two ticks");
 } // namespace constants
 
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef DAMAGE_TRACKER_HPP
+#define DAMAGE_TRACKER_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <vector>
+
+class DamageTracker
+{
+private:
+	struct TrackedRect
+	{
+		SDL_Rect rect;
+		std::uint32_t tag;
+	};
+
+	SDL_Rect bounds_;
+
+	std::vector<TrackedRect> previous_;
+	std::vector<TrackedRect> current_;
+	std::vector<SDL_Rect> pending_;
+	std::vector<SDL_Rect> dirty_;
+
+	void AddDirty(const SDL_Rect& rect);
+
+	void MergeDirty();
+
+public:
+	DamageTracker(int width, int height);
+
+	~DamageTracker();
+
+	void Track(const SDL_Rect& rect, std::uint32_t tag);
+
+	void Invalidate(const SDL_Rect& rect);
+
+	void InvalidateAll();
+
+	void Resolve();
+
+	void Spread(const SDL_Rect& rect);
+
+	const std::vector<SDL_Rect>& DirtyRects() const;
+
+	long DirtyArea() const;
+
+	static std::uint32_t ClipTag(const SDL_Rect& clip);
+};
+
+#endif
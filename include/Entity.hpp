@@ -1,7 +1,12 @@
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
 
-#include "Texture.hpp"
+#include "TextureAtlas.hpp"
+#include "DamageTracker.hpp"
+#include "Snapshot.hpp"
+#include "CollisionMask.hpp"
+#include "Random.hpp"
+#include "Fixed.hpp"
 
 #include <memory>
 
@@ -11,14 +16,21 @@ class Entity
 {
 protected:
 	Game* game_;
-	Texture* sprites_texture_;
+	TextureAtlas* atlas_;
 	float scale_;
+	Fixed x_;
+	Fixed previous_x_;
+	RandomStream random_;
+
+	void Scroll();
+
+	int RenderX() const;
 
 public:
 	SDL_Rect bounding_box_;
 	SDL_Rect sprites_clip_;
 
-	Entity(Game* game, Texture* sprites_texture);
+	Entity(Game* game, TextureAtlas* atlas, const RandomStream& random);
 
 	virtual ~Entity();
 
@@ -29,6 +41,16 @@ public:
 	virtual void Render() = 0;
 
 	virtual void Respawn() = 0;
+
+	virtual void SaveState(EntityState& state) const = 0;
+
+	virtual void LoadState(const EntityState& state) = 0;
+
+	virtual const CollisionMask& Mask() const = 0;
+
+	void SetX(int x);
+
+	void TrackDamage(DamageTracker& damage_tracker) const;
 };
 
 #endif
\ No newline at end of file
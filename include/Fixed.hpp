@@ -0,0 +1,106 @@
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <cstdint>
+
+// 16.16 fixed point for everything the simulation integrates. Integer arithmetic only, so every compiler and
+// optimization level produces the same bits; floats only appear when a value is handed to rendering.
+struct Fixed
+{
+	static constexpr int fraction_bits = 16;
+	static constexpr std::int32_t one = 1 << fraction_bits;
+
+	std::int32_t raw;
+
+	static constexpr Fixed FromRaw(std::int32_t raw)
+	{
+		return { raw };
+	}
+
+	static constexpr Fixed FromInt(int value)
+	{
+		return { value * one };
+	}
+
+	// A non-negative rate given per second as a step per tick, rounded to the nearest step.
+	static constexpr Fixed PerTick(int per_second, int tick_rate)
+	{
+		return { static_cast<std::int32_t>((static_cast<std::int64_t>(per_second) * one + tick_rate / 2) / tick_rate) };
+	}
+
+	static constexpr Fixed PerTickSquared(int per_second_squared, int tick_rate)
+	{
+		const std::int64_t ticks_squared = static_cast<std::int64_t>(tick_rate) * tick_rate;
+		return { static_cast<std::int32_t>((static_cast<std::int64_t>(per_second_squared) * one + ticks_squared / 2) / ticks_squared) };
+	}
+
+	// Rounds towards negative infinity without relying on how negative numbers are shifted.
+	constexpr int Floor() const
+	{
+		return raw >= 0 ? raw / one : -((-static_cast<std::int64_t>(raw) + one - 1) / one);
+	}
+
+	constexpr float ToFloat() const
+	{
+		return static_cast<float>(raw) / one;
+	}
+
+	constexpr Fixed operator+(Fixed other) const
+	{
+		return { raw + other.raw };
+	}
+
+	constexpr Fixed operator-(Fixed other) const
+	{
+		return { raw - other.raw };
+	}
+
+	constexpr Fixed operator-() const
+	{
+		return { -raw };
+	}
+
+	constexpr Fixed operator*(Fixed other) const
+	{
+		return { static_cast<std::int32_t>(static_cast<std::int64_t>(raw) * other.raw / one) };
+	}
+
+	constexpr Fixed operator/(Fixed other) const
+	{
+		return { static_cast<std::int32_t>(static_cast<std::int64_t>(raw) * one / other.raw) };
+	}
+
+	Fixed& operator+=(Fixed other)
+	{
+		raw += other.raw;
+		return *this;
+	}
+
+	Fixed& operator-=(Fixed other)
+	{
+		raw -= other.raw;
+		return *this;
+	}
+
+	constexpr bool operator<(Fixed other) const
+	{
+		return raw < other.raw;
+	}
+
+	constexpr bool operator<=(Fixed other) const
+	{
+		return raw <= other.raw;
+	}
+
+	constexpr bool operator>=(Fixed other) const
+	{
+		return raw >= other.raw;
+	}
+
+	constexpr bool operator==(Fixed other) const
+	{
+		return raw == other.raw;
+	}
+};
+
+#endif
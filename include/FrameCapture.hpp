@@ -0,0 +1,74 @@
+#ifndef FRAME_CAPTURE_HPP
+#define FRAME_CAPTURE_HPP
+
+#include <SDL2/SDL.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat
+{
+	PNG_SEQUENCE, RAW_VIDEO
+};
+
+class FrameCapture
+{
+private:
+	struct Frame
+	{
+		std::vector<std::uint8_t> pixels;
+		std::uint64_t index;
+	};
+
+	CaptureFormat format_;
+	std::string path_;
+	int width_;
+	int height_;
+	int pitch_;
+
+	std::vector<Frame> frames_;
+	std::vector<int> free_frames_;
+	std::deque<int> queued_frames_;
+
+	std::mutex mutex_;
+	std::condition_variable frame_queued_;
+	std::vector<std::thread> workers_;
+	bool stopping_;
+
+	std::FILE* raw_file_;
+
+	std::uint64_t next_index_;
+	std::uint64_t encoded_;
+	std::uint64_t dropped_;
+
+	void Work();
+
+	void Encode(const Frame& frame);
+
+	int AcquireFrame();
+
+	void QueueFrame(int slot, bool filled);
+
+public:
+	FrameCapture(CaptureFormat format, const std::string& path);
+
+	~FrameCapture();
+
+	bool Start(int width, int height, int buffer_count, int worker_count);
+
+	void Capture(SDL_Renderer* renderer);
+
+	void Capture(const void* pixels, int pitch);
+
+	void Stop();
+
+	std::uint64_t Dropped();
+};
+
+#endif
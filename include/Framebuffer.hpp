@@ -0,0 +1,44 @@
+#ifndef FRAMEBUFFER_HPP
+#define FRAMEBUFFER_HPP
+
+#include <SDL2/SDL.h>
+
+#include <vector>
+
+// ARGB8888 pixels in system memory that sprites are composited into on the CPU, for machines without a usable GPU.
+class Framebuffer
+{
+private:
+	int width_;
+	int height_;
+	std::vector<Uint32> pixels_;
+	std::vector<Uint32> row_;
+	SDL_Rect clip_;
+
+	static void CompositeSpan(const Uint32* source, Uint32* destination, int count);
+
+public:
+	Framebuffer(int width, int height);
+
+	~Framebuffer();
+
+	void SetClip(const SDL_Rect* clip);
+
+	void Clear(Uint32 color);
+
+	void FillRect(const SDL_Rect& rect, Uint32 color);
+
+	void BlendRect(const SDL_Rect& rect, Uint32 color);
+
+	void Blit(const SDL_Surface* source, const SDL_Rect& source_rect, const SDL_Rect& destination);
+
+	const Uint32* Pixels(int x = 0, int y = 0) const;
+
+	int Width() const;
+
+	int Height() const;
+
+	int Pitch() const;
+};
+
+#endif
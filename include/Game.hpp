@@ -2,48 +2,127 @@
 #define GAME_HPP
 
 #include "Texture.hpp"
+#include "NumberLabel.hpp"
+#include "TextureAtlas.hpp"
 #include "Player.hpp"
 #include "Obstacle.hpp"
 #include "BonusItem.hpp"
+#include "DamageTracker.hpp"
+#include "FrameCapture.hpp"
+#include "Autopilot.hpp"
+#include "MetricsLog.hpp"
+#include "MetricsExport.hpp"
+#include "GameClock.hpp"
+#include "SnapshotRing.hpp"
+#include "Music.hpp"
+#include "ParticleSystem.hpp"
+#include "Framebuffer.hpp"
+#include "AllocationTracker.hpp"
+#include "Options.hpp"
+#include "Fixed.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
 
+#include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <vector>
-#include <random>
 
 class Game
 {
 private:
+	Options options_;
+
 	bool initialized_;
 	bool running_;
-	int ground_scrolling_offset_;
+	Fixed ground_scrolling_offset_;
+	Fixed previous_ground_scrolling_offset_;
+	// scrolling_speed_ as a step per tick, updated with it so the tick never divides.
+	Fixed scroll_per_tick_;
+	std::uint64_t tick_count_;
+	// Unlike tick_count_ this survives resets and rewinds.
+	std::uint64_t ticks_run_;
+	int displayed_score_;
+
+	long pixels_redrawn_;
+	int frames_skipped_;
+	int native_scale_;
+	int resets_;
 
 	std::unique_ptr<Player> player_;
-	std::unique_ptr<Texture> background_texture_;
-	std::unique_ptr<Texture> sprites_texture_;
-	std::unique_ptr<Texture> score_info_;
+	std::unique_ptr<TextureAtlas> atlas_;
+	std::unique_ptr<NumberLabel> score_info_;
 	std::unique_ptr<Texture> game_over_info_;
+	std::unique_ptr<DamageTracker> damage_tracker_;
+	SDL_Texture* scene_target_;
+	std::unique_ptr<Framebuffer> framebuffer_;
+	SDL_Texture* framebuffer_texture_;
+	std::unique_ptr<FrameCapture> frame_capture_;
+	std::unique_ptr<Autopilot> autopilot_;
+	std::unique_ptr<MetricsLog> metrics_log_;
+	std::unique_ptr<MetricsExport> metrics_export_;
+	std::unique_ptr<Music> music_;
+	GameClock clock_;
+	SnapshotRing snapshots_;
+	std::FILE* checksum_log_;
+	double snapshot_time_;
+	int snapshot_count_;
+	double particle_update_time_;
+	double particle_render_time_;
+
+	void RenderScene();
+
+	void RenderParticles();
+
+	int GroundX() const;
+
+	void RenderHud();
+
+	void UpscaleScene();
+
+	void Rasterize();
+
+	void TrackScene();
+
+	void Present();
+
+	bool CheckAllocations(std::uint64_t frame, AllocCounts* second_counts);
+
+	void PublishMetrics(double frame_time, int ticks);
+
+	void SetScrollingSpeed(int scrolling_speed);
 
 public:
 	bool game_over_;
 	int score_;
 	int scrolling_speed_;
+	int tick_rate_;
+	float tick_length_;
+	float render_alpha_;
+	Fixed gravity_per_tick_;
+	Fixed jump_velocity_per_tick_;
 	int background_without_ground_h_;
 
 	std::vector<std::unique_ptr<Obstacle>> obstacles_;
 	std::vector<std::unique_ptr<BonusItem>> bonus_items_;
+	std::unique_ptr<ParticleSystem> particles_;
+	int rightmost_obstacle_x_;
+	int rightmost_bonus_item_x_;
 
-	std::mt19937_64 mt_;
-	std::uniform_int_distribution<int> random_index_;
+	// Built once by InitAssets and shared by every entity, so spawning and rewinding never allocate.
+	CollisionMask player_masks_[2];
+	CollisionMask obstacle_masks_[obstacle_type_count];
+	CollisionMask bonus_item_masks_[bonus_item_type_count];
+
+	std::uint64_t seed_;
 
 	TTF_Font* font_;
 	SDL_Window* window_;
 	SDL_Renderer* renderer_;
 
-	Game();
+	Game(const Options& options);
 
 	~Game();
 
@@ -55,19 +134,29 @@ public:
 
 	void SpawnObjects();
 
-	void Run();
+	bool Run();
 
 	void HandleEvents();
 
+	void HandleEvent(SDL_Event* e);
+
 	void Tick();
 
-	void Render();
+	bool Render();
 
 	void Stop();
 
 	void Reset();
 
 	void UpdateScoreText();
+
+	Fixed ScrollPerTick() const;
+
+	void SaveSnapshot(Snapshot& snapshot) const;
+
+	void LoadSnapshot(const Snapshot& snapshot);
+
+	void Rewind(int ticks);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef GAME_CLOCK_HPP
+#define GAME_CLOCK_HPP
+
+#include <cstdint>
+
+class GameClock
+{
+private:
+	long double tick_length_;
+	long double accumulator_;
+	double time_scale_;
+	int ticks_per_frame_;
+	long double max_frame_time_;
+	long double dropped_time_;
+	bool uncapped_;
+	bool paused_;
+	int pending_steps_;
+
+public:
+	GameClock(long double tick_length);
+
+	~GameClock();
+
+	int Advance(long double elapsed);
+
+	void SetTimeScale(double time_scale);
+
+	void SetTicksPerFrame(int ticks_per_frame);
+
+	void SetMaxFrameTime(long double max_frame_time);
+
+	std::uint64_t DroppedTicks() const;
+
+	void SetUncapped(bool uncapped);
+
+	bool Uncapped() const;
+
+	float Alpha() const;
+
+	void TogglePause();
+
+	void Step();
+};
+
+#endif
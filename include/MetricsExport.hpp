@@ -0,0 +1,77 @@
+#ifndef METRICS_EXPORT_HPP
+#define METRICS_EXPORT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct MetricsSample
+{
+	std::uint64_t frame;
+	double fps;
+	double tick_rate;
+	double frame_ms_p50;
+	double frame_ms_p95;
+	double frame_ms_p99;
+	std::uint32_t obstacles;
+	std::uint32_t bonus_items;
+	std::uint32_t particles;
+	std::uint32_t draw_calls;
+	std::uint32_t allocations;
+	std::uint32_t surfaces;
+	std::uint32_t textures;
+	std::int32_t score;
+	std::int32_t scrolling_speed;
+	std::int32_t game_over;
+};
+
+static_assert(sizeof(MetricsSample) % sizeof(std::uint64_t) == 0, "MetricsSample is copied in whole 64-bit words");
+
+// The layout of the shared-memory segment. The game is the only writer and never waits: a sequence number that is
+// odd while the sample is being written tells readers to retry, readers never block the game. The magic number is
+// stored last, so a reader that sees it also sees the rest of the header.
+struct SharedMetrics
+{
+	static constexpr std::uint32_t magic_value = 0x53534D54;
+	static constexpr std::uint32_t version_value = 2;
+	static constexpr std::size_t word_count = sizeof(MetricsSample) / sizeof(std::uint64_t);
+
+	std::atomic<std::uint32_t> magic;
+	std::atomic<std::uint32_t> version;
+	std::atomic<std::uint64_t> sequence;
+	std::atomic<std::uint64_t> words[word_count];
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Shared metrics need lock-free 32-bit atomics");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared metrics need lock-free 64-bit atomics");
+
+class MetricsExport
+{
+private:
+	static constexpr std::size_t window = 120;
+
+	std::string name_;
+	SharedMetrics* shared_;
+	std::uint64_t frame_;
+
+	double frame_times_[window];
+	int frame_ticks_[window];
+	std::size_t next_;
+	std::size_t filled_;
+
+public:
+	MetricsExport(const std::string& name);
+
+	~MetricsExport();
+
+	bool Open();
+
+	void Publish(MetricsSample& sample, double frame_time, int ticks);
+
+	static SharedMetrics* Attach(const std::string& name);
+
+	static bool Read(const SharedMetrics& shared, MetricsSample& sample);
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef METRICS_LOG_HPP
+#define METRICS_LOG_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+struct FrameMetrics
+{
+	int frames = 0;
+	int ticks = 0;
+	double frame_time_total = 0.0;
+	double frame_time_max = 0.0;
+	std::uint64_t allocations = 0;
+	std::uint64_t allocated_bytes = 0;
+};
+
+class MetricsLog
+{
+private:
+	std::string path_;
+	std::FILE* file_;
+	double elapsed_;
+
+	static long ResidentSetKilobytes();
+
+public:
+	MetricsLog(const std::string& path);
+
+	~MetricsLog();
+
+	bool Open();
+
+	void Write(const FrameMetrics& metrics, int score, int scrolling_speed, int resets);
+};
+
+#endif
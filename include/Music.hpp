@@ -0,0 +1,91 @@
+#ifndef MUSIC_HPP
+#define MUSIC_HPP
+
+#include "PcmRing.hpp"
+
+#include <SDL2/SDL.h>
+#include <vorbis/vorbisfile.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams OGG tracks from disk. A decoder thread keeps a bounded PCM ring per deck filled, the audio callback
+// only mixes what is already decoded, and switching tracks cross-fades between the two decks.
+class Music
+{
+private:
+	// Only the audio callback moves a deck to IDLE, so the decoder never touches a ring the callback may be reading.
+	enum DeckState
+	{
+		IDLE, PLAYING, STOPPING
+	};
+
+	struct Deck
+	{
+		OggVorbis_File file;
+		bool file_open;
+		int channels;
+		PcmRing ring;
+		std::atomic<int> state;
+		float gain;
+
+		Deck();
+	};
+
+	Deck decks_[2];
+	std::atomic<int> active_deck_;
+	std::atomic<int> fade_frames_;
+	std::atomic<std::uint64_t> underruns_;
+	std::vector<std::int16_t> mix_buffer_;
+
+	std::thread decoder_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool stopping_;
+	bool request_pending_;
+	// Track paths live in the game's options for as long as the music, so a request stores the pointer and the game
+	// loop never copies a string.
+	const char* request_path_;
+	int request_fade_ms_;
+	std::string failed_path_;
+
+	int frequency_;
+	int channels_;
+	// Updated by the decoder on every pass, so it can be reported while the music plays.
+	std::atomic<double> decode_cpu_seconds_;
+	bool opened_;
+
+	void Decode();
+
+	bool StartTrack(const std::string& path, int fade_ms);
+
+	bool Load(Deck& deck, const std::string& path);
+
+	void Fill(Deck& deck);
+
+	static void Mix(void* music, Uint8* stream, int length);
+
+	static double ThreadCpuSeconds();
+
+public:
+	Music();
+
+	~Music();
+
+	bool Open();
+
+	void CrossFade(const char* path, int fade_ms);
+
+	void Close();
+
+	std::uint64_t Underruns() const;
+
+	double DecodeCpuSeconds() const;
+};
+
+#endif
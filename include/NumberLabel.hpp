@@ -0,0 +1,39 @@
+#ifndef NUMBER_LABEL_HPP
+#define NUMBER_LABEL_HPP
+
+#include "Texture.hpp"
+#include "Framebuffer.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+// A fixed label followed by a number. The label and a strip of the ten digits are rendered once when loading, so
+// changing the number only picks different clips out of the strip and never creates a surface or texture.
+class NumberLabel
+{
+private:
+	Texture label_;
+	Texture digits_;
+	// Left edge of every digit in the strip, and the strip's width at the end.
+	int digit_x_[11];
+	char value_digits_[11];
+	int value_length_;
+	int value_width_;
+
+public:
+	NumberLabel();
+
+	~NumberLabel();
+
+	bool Load(SDL_Renderer* renderer, TTF_Font* font, const char* label, const SDL_Color& color, Framebuffer* framebuffer);
+
+	void SetValue(int value);
+
+	int Width() const;
+
+	int Height() const;
+
+	void Render(SDL_Renderer* renderer, int x, int y);
+};
+
+#endif
@@ -10,16 +10,20 @@ enum class ObstacleType
 	SINGLE_BOX, DOUBLE_BOX, QUAD_BOX, FIRE
 };
 
+inline constexpr int obstacle_type_count = static_cast<int>(ObstacleType::FIRE) + 1;
+
 class Obstacle : public Entity
 {
 private:
 	ObstacleType type_;
 	
 public:
-	Obstacle(Game* game, Texture* sprites_texture, ObstacleType type, int x, float scale);
+	Obstacle(Game* game, TextureAtlas* atlas, ObstacleType type, int x, float scale, const RandomStream& random);
 
 	~Obstacle();
 
+	void Reset(ObstacleType type, int x, const RandomStream& random);
+
 	void HandleEvent(SDL_Event* e) override;
 
 	void Tick() override;
@@ -28,7 +32,17 @@ public:
 
 	void Respawn() override;
 
+	void SaveState(EntityState& state) const override;
+
+	void LoadState(const EntityState& state) override;
+
+	const CollisionMask& Mask() const override;
+
 	void SetType(ObstacleType type);
+
+	static SDL_Rect SpriteClip(const TextureAtlas& atlas, ObstacleType type);
+
+	static CollisionMask BuildMask(const TextureAtlas& atlas, ObstacleType type, int scale);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct Options
+{
+	bool software_renderer = false;
+	bool damage_tracking = false;
+	bool stats = false;
+	bool low_res = false;
+	bool cpu_raster = false;
+	bool headless = false;
+	bool no_music = false;
+	std::string music_path = "res/sfx/music.ogg";
+	std::string game_over_music_path = "res/sfx/game_over.ogg";
+	std::size_t particle_stress = 0;
+	std::string capture_png_dir;
+	std::string capture_raw_path;
+	bool autopilot = false;
+	bool auto_reset = false;
+	std::string metrics_path;
+	std::string metrics_shm_name;
+	std::uint64_t seed = 0;
+	bool fixed_seed = false;
+	int tick_rate = 60;
+	double time_scale = 1.0;
+	int ticks_per_frame = 0;
+	bool uncapped = false;
+	std::string checksum_log_path;
+	std::uint64_t exit_after_ticks = 0;
+	bool alloc_stats = false;
+	int alloc_budget = -1;
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include "Framebuffer.hpp"
+#include "TextureAtlas.hpp"
+#include "Random.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class ParticleEmitter
+{
+	DUST, SPARKLE, EMBER, COUNT
+};
+
+struct EmitterDef
+{
+	int count;
+	SDL_Rect clip;
+	float speed_min;
+	float speed_max;
+	float angle_min;
+	float angle_max;
+	float gravity;
+	float life_min;
+	float life_max;
+	float size;
+	SDL_Color color;
+};
+
+// Fixed-capacity particle pool stored as one array per attribute, drawn from the atlas in a single geometry batch.
+class ParticleSystem
+{
+private:
+	TextureAtlas* atlas_;
+	std::size_t capacity_;
+	std::size_t count_;
+
+	std::vector<float> x_;
+	std::vector<float> y_;
+	std::vector<float> vx_;
+	std::vector<float> vy_;
+	std::vector<float> ay_;
+	std::vector<float> age_;
+	std::vector<float> life_;
+	std::vector<std::uint8_t> emitter_;
+
+	std::vector<SDL_Vertex> vertices_;
+	std::vector<int> indices_;
+	SDL_FPoint tex_coords_[static_cast<int>(ParticleEmitter::COUNT)][2];
+
+	RandomStream random_;
+	SDL_Rect bounds_;
+
+	void Spawn(int emitter, float x, float y);
+
+public:
+	ParticleSystem(TextureAtlas* atlas, std::size_t capacity, const RandomStream& random);
+
+	~ParticleSystem();
+
+	void Emit(ParticleEmitter emitter, float x, float y);
+
+	void Saturate(ParticleEmitter emitter, std::size_t count, const SDL_Rect& area);
+
+	void Tick(float scroll, float dt);
+
+	void Render(SDL_Renderer* renderer);
+
+	void Render(Framebuffer& framebuffer);
+
+	void Clear();
+
+	std::size_t Count() const;
+
+	const SDL_Rect& Bounds() const;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef PCM_RING_HPP
+#define PCM_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lock-free single producer, single consumer ring of 16-bit samples.
+class PcmRing
+{
+private:
+	std::vector<std::int16_t> samples_;
+	std::size_t mask_;
+	std::atomic<std::size_t> read_;
+	std::atomic<std::size_t> write_;
+
+public:
+	PcmRing(std::size_t capacity_pow2);
+
+	~PcmRing();
+
+	std::size_t Write(const std::int16_t* samples, std::size_t count);
+
+	std::size_t Read(std::int16_t* samples, std::size_t count);
+
+	std::size_t Free() const;
+
+	void Reset();
+};
+
+#endif
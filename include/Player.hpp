@@ -1,7 +1,13 @@
 #ifndef PLAYER_HPP
 #define PLAYER_HPP
 
-#include "Texture.hpp"
+#include "TextureAtlas.hpp"
+#include "DamageTracker.hpp"
+#include "Snapshot.hpp"
+#include "RectBatch.hpp"
+#include "CollisionMask.hpp"
+#include "Entity.hpp"
+#include "Fixed.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
@@ -14,15 +20,19 @@ class Player
 {
 private:
 	Game* game_;
+	TextureAtlas* atlas_;
 
-	SDL_FRect bounding_box_;
+	SDL_Rect bounding_box_;
+	Fixed y_;
+	Fixed previous_y_;
 	bool grounded_;
 	float speed_;
-	float vy_;
-	float ay_;
-	float mass_;
-	float Fy_;
-	float Fy_net_;
+	Fixed vy_;
+	Fixed ay_;
+	Fixed mass_;
+	Fixed Fy_;
+	Fixed Fy_net_;
+	float scale_;
 
 	Mix_Chunk* jump_sfx_;
 	Mix_Chunk* pickup_sfx_;
@@ -31,12 +41,15 @@ private:
 	SDL_Rect sprite_clips_[2];
 	SDL_Rect* current_clip_;
 
-	std::unique_ptr<Texture> texture_;
+	RectBatch obstacle_boxes_;
+	RectBatch bonus_item_boxes_;
 
 public:
-	Player(Game* game);
+	Player(Game* game, TextureAtlas* atlas);
 
 	~Player();
+
+	void Reset();
 	
 	void HandleEvent(SDL_Event* e);
 
@@ -44,9 +57,27 @@ public:
 
 	void Render();
 
+	void TrackDamage(DamageTracker& damage_tracker) const;
+
+	int RenderY() const;
+
 	bool Grounded();
 
-	bool Collides(const SDL_Rect& obstacle_rect);
+	bool IsGrounded() const;
+
+	const SDL_Rect& BoundingBox() const;
+
+	void SaveState(PlayerState& state) const;
+
+	void LoadState(const PlayerState& state);
+
+	SDL_Rect CollisionBox() const;
+
+	bool MaskOverlaps(const SDL_Rect& player_rect, const Entity& entity) const;
+
+	static SDL_Rect SpriteClip(const TextureAtlas& atlas, int frame);
+
+	static CollisionMask BuildMask(const TextureAtlas& atlas, int frame);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+enum class RandomSubsystem : std::uint32_t
+{
+	OBSTACLES = 1, BONUS_ITEMS, PARTICLES
+};
+
+// Counter-based generator: the n-th value of a stream is a hash of the stream's key and n, so a stream is two words
+// of plain data that can be copied into a snapshot, and no stream's values depend on when other streams were drawn from.
+struct RandomStream
+{
+	std::uint64_t key;
+	std::uint64_t counter;
+
+	static RandomStream Create(std::uint64_t seed, RandomSubsystem subsystem, std::uint32_t index);
+
+	static std::uint64_t At(std::uint64_t key, std::uint64_t counter);
+
+	std::uint64_t Next();
+
+	int Below(int bound);
+
+	float Uniform(float min, float max);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RECT_BATCH_HPP
+#define RECT_BATCH_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rectangles packed as separate edge arrays, so one rectangle can be tested against many of them with SIMD.
+class RectBatch
+{
+private:
+	std::vector<std::int32_t> left_;
+	std::vector<std::int32_t> top_;
+	std::vector<std::int32_t> right_;
+	std::vector<std::int32_t> bottom_;
+	std::size_t size_;
+
+public:
+	// Arrays are padded to this many lanes with rects that never overlap anything, so kernels have no tail loop.
+	static constexpr std::size_t lanes = 8;
+
+	RectBatch();
+
+	~RectBatch();
+
+	void Clear();
+
+	void Add(const SDL_Rect& rect);
+
+	std::size_t Size() const;
+
+	void Overlaps(const SDL_Rect& rect, std::uint64_t* mask) const;
+
+	std::uint64_t Overlaps(const SDL_Rect& rect) const;
+
+	static const char* KernelName();
+
+	// Switches every batch to the kernel called name ("scalar", "SSE2" or "AVX2"), if this CPU supports it.
+	static bool UseKernel(const char* name);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "Constants.hpp"
+#include "Random.hpp"
+#include "Fixed.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <type_traits>
+
+struct PlayerState
+{
+	SDL_Rect bounding_box;
+	Fixed y;
+	Fixed vy;
+	Fixed ay;
+	Fixed Fy;
+	int frame;
+	int clip;
+	bool grounded;
+};
+
+struct EntityState
+{
+	SDL_Rect bounding_box;
+	Fixed x;
+	int type;
+	RandomStream random;
+};
+
+// Everything the simulation needs to continue from a given tick. Plain data only, so saving one is a handful of stores.
+struct Snapshot
+{
+	std::uint64_t tick_count;
+	int score;
+	int scrolling_speed;
+	Fixed ground_scrolling_offset;
+	bool game_over;
+
+	PlayerState player;
+	EntityState obstacles[constants::obstacle_count];
+	EntityState bonus_items[constants::bonus_item_count];
+
+	std::uint64_t Checksum() const;
+};
+
+static_assert(std::is_trivially_copyable_v<Snapshot>, "Snapshot must stay plain data");
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SNAPSHOT_RING_HPP
+#define SNAPSHOT_RING_HPP
+
+#include "Snapshot.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class SnapshotRing
+{
+private:
+	std::vector<Snapshot> snapshots_;
+	std::size_t head_;
+	std::size_t size_;
+
+public:
+	SnapshotRing(std::size_t capacity);
+
+	~SnapshotRing();
+
+	Snapshot& Push();
+
+	const Snapshot* Rewind(std::size_t ticks);
+
+	void Clear();
+
+	std::size_t Size() const;
+};
+
+#endif
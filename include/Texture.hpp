@@ -1,6 +1,8 @@
 #ifndef TEXTURE_HPP
 #define TEXTURE_HPP
 
+#include "Framebuffer.hpp"
+
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
@@ -8,9 +10,15 @@ class Texture
 {
 public:
 	SDL_Texture* texture_;
+	// With a framebuffer the pixels stay in an ARGB8888 surface and are drawn on the CPU instead.
+	SDL_Surface* surface_;
+	Framebuffer* framebuffer_;
 	int width_;
 	int height_;
 
+	// Render calls since the game last reset it, for the live metrics.
+	static int draw_calls_;
+
 	Texture();
 
 	~Texture();
@@ -19,6 +27,8 @@ public:
 
 	bool LoadFromPath(SDL_Renderer* renderer, const char* path);
 
+	bool LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
+
 	bool LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& text_color, int text_length = -1);
 
 	void Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip = nullptr, float scale = 1.0);
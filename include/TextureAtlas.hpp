@@ -0,0 +1,38 @@
+#ifndef TEXTURE_ATLAS_HPP
+#define TEXTURE_ATLAS_HPP
+
+#include "Texture.hpp"
+#include "CollisionMask.hpp"
+
+#include <SDL2/SDL.h>
+
+enum class AtlasRegion
+{
+	BACKGROUND, OBJECTS, PLAYER, COUNT
+};
+
+class TextureAtlas
+{
+private:
+	SDL_Rect regions_[static_cast<int>(AtlasRegion::COUNT)];
+	CollisionMask mask_;
+
+	static CollisionMask OpaquePixels(SDL_Surface* surface);
+
+	static bool Pack(SDL_Surface** surfaces, SDL_Rect* regions, int count, int padding, int& atlas_w, int& atlas_h);
+
+public:
+	Texture texture_;
+
+	TextureAtlas();
+
+	~TextureAtlas();
+
+	bool Load(SDL_Renderer* renderer);
+
+	SDL_Rect Clip(AtlasRegion region, int x, int y, int w, int h) const;
+
+	CollisionMask Mask(const SDL_Rect& clip, int scale) const;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include "AllocationTracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Only the thread that called Enable counts, so the music decoder and capture workers never touch the counters.
+static thread_local bool counting = false;
+
+AllocPhase AllocationTracker::phase_ = AllocPhase::OTHER;
+AllocCounts AllocationTracker::frame_[static_cast<int>(AllocPhase::COUNT)];
+
+void AllocationTracker::Enable()
+{
+	counting = true;
+}
+
+bool AllocationTracker::Enabled()
+{
+	return counting;
+}
+
+void AllocationTracker::SetPhase(AllocPhase phase)
+{
+	phase_ = phase;
+}
+
+void AllocationTracker::CountAllocation(std::size_t bytes)
+{
+	if (counting)
+	{
+		AllocCounts& counts = frame_[static_cast<int>(phase_)];
+
+		++counts.allocations;
+		counts.bytes += bytes;
+	}
+}
+
+void AllocationTracker::CountFree()
+{
+	if (counting)
+	{
+		++frame_[static_cast<int>(phase_)].frees;
+	}
+}
+
+SDL_Surface* AllocationTracker::CountSurface(SDL_Surface* surface)
+{
+	if (counting && surface != nullptr)
+	{
+		++frame_[static_cast<int>(phase_)].surfaces;
+	}
+
+	return surface;
+}
+
+SDL_Texture* AllocationTracker::CountTexture(SDL_Texture* texture)
+{
+	if (counting && texture != nullptr)
+	{
+		++frame_[static_cast<int>(phase_)].textures;
+	}
+
+	return texture;
+}
+
+const AllocCounts& AllocationTracker::Frame(AllocPhase phase)
+{
+	return frame_[static_cast<int>(phase)];
+}
+
+AllocCounts AllocationTracker::FrameTotal()
+{
+	AllocCounts total;
+
+	for (const AllocCounts& counts : frame_)
+	{
+		total.allocations += counts.allocations;
+		total.bytes += counts.bytes;
+		total.frees += counts.frees;
+		total.surfaces += counts.surfaces;
+		total.textures += counts.textures;
+	}
+
+	return total;
+}
+
+void AllocationTracker::EndFrame()
+{
+	for (AllocCounts& counts : frame_)
+	{
+		counts = AllocCounts();
+	}
+}
+
+const char* AllocationTracker::PhaseName(AllocPhase phase)
+{
+	constexpr const char* names[static_cast<int>(AllocPhase::COUNT)] = { "events", "tick", "render", "other" };
+	return names[static_cast<int>(phase)];
+}
+
+static void* Allocate(std::size_t size)
+{
+	AllocationTracker::CountAllocation(size);
+
+	// malloc(0) may return nullptr, but operator new has to hand out a unique pointer.
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+static void Free(void* pointer)
+{
+	if (pointer != nullptr)
+	{
+		AllocationTracker::CountFree();
+		std::free(pointer);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	void* pointer = Allocate(size);
+
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	Free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	Free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	Free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	Free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	Free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	Free(pointer);
+}
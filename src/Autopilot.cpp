@@ -0,0 +1,69 @@
+#include "Autopilot.hpp"
+#include "Game.hpp"
+#include "Constants.hpp"
+
+Autopilot::Autopilot(Game* game, bool auto_reset) : game_(game), auto_reset_(auto_reset)
+{
+}
+
+Autopilot::~Autopilot()
+{
+}
+
+void Autopilot::Tick(const Player& player)
+{
+	if (game_->game_over_)
+	{
+		if (auto_reset_)
+		{
+			PressKey(SDLK_r);
+		}
+
+		return;
+	}
+
+	if (player.IsGrounded() && ObstacleAhead(player.BoundingBox()))
+	{
+		PressKey(SDLK_SPACE);
+	}
+}
+
+void Autopilot::PressKey(SDL_Keycode key)
+{
+	// Goes through the same path as a real key press, so the game cannot tell the difference.
+	SDL_Event e;
+	SDL_memset(&e, 0, sizeof(e));
+	e.type = SDL_KEYDOWN;
+	e.key.state = SDL_PRESSED;
+	e.key.keysym.sym = key;
+
+	game_->HandleEvent(&e);
+}
+
+bool Autopilot::ObstacleAhead(const SDL_Rect& player_box)
+{
+	// A jump peaks after jump_velocity / gravity ticks; the jump is timed so the peak is right above the middle of the obstacle.
+	// Its decisions feed back into the simulation, so they are made in fixed point like the physics.
+	const Fixed ticks_to_peak = game_->jump_velocity_per_tick_ / game_->gravity_per_tick_;
+	const Fixed jump_distance = game_->ScrollPerTick() * ticks_to_peak;
+	const Fixed player_center = Fixed::FromInt(player_box.x) + Fixed::FromRaw(player_box.w * (Fixed::one / 2));
+
+	for (const std::unique_ptr<Obstacle>& obstacle : game_->obstacles_)
+	{
+		const SDL_Rect& box = obstacle->bounding_box_;
+
+		if (box.x + box.w < player_box.x)
+		{
+			continue;
+		}
+
+		const Fixed distance = Fixed::FromInt(box.x) + Fixed::FromRaw(box.w * (Fixed::one / 2)) - player_center;
+
+		if (distance <= jump_distance)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
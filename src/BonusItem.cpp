@@ -4,17 +4,24 @@
 
 #include <iostream>
 
-BonusItem::BonusItem(Game* game, Texture* sprites_texture, BonusItemType type, int x, float scale) : Entity(game, sprites_texture)
+BonusItem::BonusItem(Game* game, TextureAtlas* atlas, BonusItemType type, int x, float scale, const RandomStream& random) : Entity(game, atlas, random)
 {
 	scale_ = scale;
 	SetType(type);
-	bounding_box_.x = x;
+	SetX(x);
 }
 
 BonusItem::~BonusItem()
 {
 }
 
+void BonusItem::Reset(BonusItemType type, int x, const RandomStream& random)
+{
+	random_ = random;
+	SetType(type);
+	SetX(x);
+}
+
 void BonusItem::HandleEvent(SDL_Event* e)
 {
 	(void) e;
@@ -22,7 +29,7 @@ void BonusItem::HandleEvent(SDL_Event* e)
 
 void BonusItem::Tick()
 {
-	bounding_box_.x -= game_->scrolling_speed_;
+	Scroll();
 
 	if (bounding_box_.x + bounding_box_.w < 0)
 	{
@@ -35,7 +42,7 @@ void BonusItem::Render()
 	switch (type_)
 	{
 	case BonusItemType::MONEY:
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, RenderX(), bounding_box_.y, &sprites_clip_, scale_);
 		break;
 	}
 }
@@ -43,27 +50,36 @@ void BonusItem::Render()
 void BonusItem::Respawn()
 {
 	constexpr int distances[4] = { 200, 400, 600, 800 };
-		
-	auto max_it = std::max_element(game_->bonus_items_.begin(), game_->bonus_items_.end(), [](const std::unique_ptr<BonusItem>& b1, const std::unique_ptr<BonusItem>& b2)
-	{
-		return b1->bounding_box_.x < b2->bounding_box_.x;
-	});
+	SetX(game_->rightmost_bonus_item_x_ + distances[random_.Below(4)]);
+}
 
-	assert(max_it != game_->bonus_items_.end());
-	bounding_box_.x = (*max_it)->bounding_box_.x + distances[game_->random_index_(game_->mt_)];
+void BonusItem::SaveState(EntityState& state) const
+{
+	state.bounding_box = bounding_box_;
+	state.x = x_;
+	state.random = random_;
+	state.type = static_cast<int>(type_);
+}
+
+void BonusItem::LoadState(const EntityState& state)
+{
+	SetType(static_cast<BonusItemType>(state.type));
+	bounding_box_ = state.bounding_box;
+	x_ = state.x;
+	previous_x_ = state.x;
+	random_ = state.random;
+}
+
+const CollisionMask& BonusItem::Mask() const
+{
+	return game_->bonus_item_masks_[static_cast<int>(type_)];
 }
 
 void BonusItem::SetType(BonusItemType type)
 {
 	type_ = type;
 
-	if (type == BonusItemType::MONEY)
-	{
-		sprites_clip_.x = 64;
-		sprites_clip_.y = 0;
-		sprites_clip_.w = 16;
-		sprites_clip_.h = 8;
-	}
+	sprites_clip_ = SpriteClip(*atlas_, type);
 
 	switch (type_)
 	{
@@ -74,3 +90,14 @@ void BonusItem::SetType(BonusItemType type)
 		break;
 	}
 }
+
+SDL_Rect BonusItem::SpriteClip(const TextureAtlas& atlas, BonusItemType type)
+{
+	(void) type;
+	return atlas.Clip(AtlasRegion::OBJECTS, 64, 0, 16, 8);
+}
+
+CollisionMask BonusItem::BuildMask(const TextureAtlas& atlas, BonusItemType type, int scale)
+{
+	return atlas.Mask(SpriteClip(atlas, type), scale);
+}
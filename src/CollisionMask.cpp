@@ -0,0 +1,108 @@
+#include "CollisionMask.hpp"
+
+#include <algorithm>
+
+CollisionMask::CollisionMask() : width_(0), height_(0), words_per_row_(0)
+{
+}
+
+CollisionMask::CollisionMask(int width, int height) : 
+	width_(width), 
+	height_(height), 
+	words_per_row_((width + 63) / 64 + 1), 
+	rows_(static_cast<std::size_t>(words_per_row_) * height, 0)
+{
+}
+
+CollisionMask::~CollisionMask()
+{
+}
+
+int CollisionMask::Width() const
+{
+	return width_;
+}
+
+int CollisionMask::Height() const
+{
+	return height_;
+}
+
+bool CollisionMask::Get(int x, int y) const
+{
+	return (rows_[static_cast<std::size_t>(y) * words_per_row_ + x / 64] >> (x % 64)) & 1;
+}
+
+void CollisionMask::Set(int x, int y)
+{
+	rows_[static_cast<std::size_t>(y) * words_per_row_ + x / 64] |= std::uint64_t(1) << (x % 64);
+}
+
+void CollisionMask::Add(const CollisionMask& other, int x, int y)
+{
+	for (int other_y = 0; other_y < other.height_; ++other_y)
+	{
+		for (int other_x = 0; other_x < other.width_; ++other_x)
+		{
+			if (other.Get(other_x, other_y))
+			{
+				Set(x + other_x, y + other_y);
+			}
+		}
+	}
+}
+
+CollisionMask CollisionMask::Scaled(const SDL_Rect& area, int scale) const
+{
+	CollisionMask scaled(area.w * scale, area.h * scale);
+
+	for (int y = 0; y < scaled.height_; ++y)
+	{
+		for (int x = 0; x < scaled.width_; ++x)
+		{
+			if (Get(area.x + x / scale, area.y + y / scale))
+			{
+				scaled.Set(x, y);
+			}
+		}
+	}
+
+	return scaled;
+}
+
+bool CollisionMask::Overlaps(const CollisionMask& other, int dx, int dy) const
+{
+	// Only the rows and columns both masks cover are compared, 64 columns per AND.
+	const int x0 = std::max(0, dx);
+	const int x1 = std::min(width_, dx + other.width_);
+	const int y0 = std::max(0, dy);
+	const int y1 = std::min(height_, dy + other.height_);
+
+	for (int y = y0; y < y1; ++y)
+	{
+		for (int x = x0; x < x1; x += 64)
+		{
+			std::uint64_t bits = Bits(x, y) & other.Bits(x - dx, y - dy);
+
+			if (x1 - x < 64)
+			{
+				bits &= (std::uint64_t(1) << (x1 - x)) - 1;
+			}
+
+			if (bits != 0)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+std::uint64_t CollisionMask::Bits(int x, int y) const
+{
+	const std::uint64_t* row = &rows_[static_cast<std::size_t>(y) * words_per_row_ + x / 64];
+	const int shift = x % 64;
+
+	return shift == 0 ? row[0] : (row[0] >> shift) | (row[1] << (64 - shift));
+}
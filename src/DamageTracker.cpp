@@ -0,0 +1,148 @@
+#include "DamageTracker.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+DamageTracker::DamageTracker(int width, int height) : bounds_({ 0, 0, width, height })
+{
+	// Room for every rect a frame tracks, so growing to a new maximum mid-game does not show up as an allocation.
+	previous_.reserve(64);
+	current_.reserve(64);
+	pending_.reserve(64);
+	dirty_.reserve(128);
+
+	InvalidateAll();
+}
+
+DamageTracker::~DamageTracker()
+{
+}
+
+void DamageTracker::Track(const SDL_Rect& rect, std::uint32_t tag)
+{
+	current_.push_back({ rect, tag });
+}
+
+void DamageTracker::Invalidate(const SDL_Rect& rect)
+{
+	pending_.push_back(rect);
+}
+
+void DamageTracker::InvalidateAll()
+{
+	pending_.push_back(bounds_);
+}
+
+void DamageTracker::Resolve()
+{
+	dirty_.clear();
+
+	for (const SDL_Rect& rect : pending_)
+	{
+		AddDirty(rect);
+	}
+
+	pending_.clear();
+
+	// Rects are matched by the order they were tracked in, anything that moved or changed its tag is redrawn at both places.
+	const std::size_t common = std::min(previous_.size(), current_.size());
+
+	for (std::size_t i = 0; i < common; ++i)
+	{
+		const TrackedRect& before = previous_[i];
+		const TrackedRect& after = current_[i];
+
+		if (before.tag != after.tag || !SDL_RectEquals(&before.rect, &after.rect))
+		{
+			AddDirty(before.rect);
+			AddDirty(after.rect);
+		}
+	}
+
+	for (std::size_t i = common; i < previous_.size(); ++i)
+	{
+		AddDirty(previous_[i].rect);
+	}
+
+	for (std::size_t i = common; i < current_.size(); ++i)
+	{
+		AddDirty(current_[i].rect);
+	}
+
+	MergeDirty();
+
+	previous_.swap(current_);
+	current_.clear();
+}
+
+void DamageTracker::Spread(const SDL_Rect& rect)
+{
+	// Called after Resolve, makes all of rect dirty when part of it already is, so whatever is drawn over rect can be
+	// clipped to the dirty rects it touches without landing on pixels that were kept from last frame.
+	for (const SDL_Rect& dirty_rect : dirty_)
+	{
+		if (SDL_HasIntersection(&dirty_rect, &rect))
+		{
+			AddDirty(rect);
+			MergeDirty();
+			return;
+		}
+	}
+}
+
+const std::vector<SDL_Rect>& DamageTracker::DirtyRects() const
+{
+	return dirty_;
+}
+
+long DamageTracker::DirtyArea() const
+{
+	long area = 0;
+
+	for (const SDL_Rect& rect : dirty_)
+	{
+		area += static_cast<long>(rect.w) * rect.h;
+	}
+
+	return area;
+}
+
+std::uint32_t DamageTracker::ClipTag(const SDL_Rect& clip)
+{
+	return (static_cast<std::uint32_t>(clip.y) << 16) | static_cast<std::uint32_t>(clip.x & 0xFFFF);
+}
+
+void DamageTracker::AddDirty(const SDL_Rect& rect)
+{
+	SDL_Rect clipped;
+
+	if (SDL_IntersectRect(&rect, &bounds_, &clipped))
+	{
+		dirty_.push_back(clipped);
+	}
+}
+
+void DamageTracker::MergeDirty()
+{
+	// Overlapping rects would be redrawn twice, so they are replaced by their union until none overlap.
+	bool merged = true;
+
+	while (merged)
+	{
+		merged = false;
+
+		for (std::size_t i = 0; i < dirty_.size() && !merged; ++i)
+		{
+			for (std::size_t j = i + 1; j < dirty_.size(); ++j)
+			{
+				if (SDL_HasIntersection(&dirty_[i], &dirty_[j]))
+				{
+					SDL_UnionRect(&dirty_[i], &dirty_[j], &dirty_[i]);
+					dirty_.erase(dirty_.begin() + j);
+					merged = true;
+					break;
+				}
+			}
+		}
+	}
+}
@@ -1,6 +1,9 @@
 #include "Entity.hpp"
+#include "Game.hpp"
 
-Entity::Entity(Game* game, Texture* sprites_texture) : game_(game), sprites_texture_(sprites_texture)
+#include <cmath>
+
+Entity::Entity(Game* game, TextureAtlas* atlas, const RandomStream& random) : game_(game), atlas_(atlas), x_(Fixed::FromInt(0)), previous_x_(Fixed::FromInt(0)), random_(random)
 {
 	bounding_box_.x = 0;
 	bounding_box_.y = 0;
@@ -16,3 +19,29 @@ Entity::Entity(Game* game, Texture* sprites_texture) : game_(game), sprites_text
 Entity::~Entity()
 {
 }
+
+void Entity::SetX(int x)
+{
+	// Placing an entity is a jump, not movement, so there is nothing to interpolate from.
+	x_ = Fixed::FromInt(x);
+	previous_x_ = x_;
+	bounding_box_.x = x;
+}
+
+void Entity::Scroll()
+{
+	previous_x_ = x_;
+	x_ -= game_->ScrollPerTick();
+	bounding_box_.x = x_.Floor();
+}
+
+int Entity::RenderX() const
+{
+	return static_cast<int>(std::floor(previous_x_.ToFloat() + (x_ - previous_x_).ToFloat() * game_->render_alpha_));
+}
+
+void Entity::TrackDamage(DamageTracker& damage_tracker) const
+{
+	const SDL_Rect render_rect = { RenderX(), bounding_box_.y, bounding_box_.w, bounding_box_.h };
+	damage_tracker.Track(render_rect, DamageTracker::ClipTag(sprites_clip_));
+}
@@ -0,0 +1,256 @@
+#include "FrameCapture.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+FrameCapture::FrameCapture(CaptureFormat format, const std::string& path) : 
+	format_(format), 
+	path_(path), 
+	width_(0), 
+	height_(0), 
+	pitch_(0), 
+	stopping_(false), 
+	raw_file_(nullptr), 
+	next_index_(0), 
+	encoded_(0), 
+	dropped_(0)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+	Stop();
+}
+
+bool FrameCapture::Start(int width, int height, int buffer_count, int worker_count)
+{
+	width_ = width;
+	height_ = height;
+	pitch_ = width_ * 4;
+
+	if (format_ == CaptureFormat::RAW_VIDEO)
+	{
+		raw_file_ = std::fopen(path_.c_str(), "wb");
+
+		if (raw_file_ == nullptr)
+		{
+			printf("Unable to open capture file %s!\n", path_.c_str());
+			return false;
+		}
+
+		// A raw stream has to be written in frame order.
+		worker_count = 1;
+	}
+	else
+	{
+		std::error_code error;
+		std::filesystem::create_directories(path_, error);
+
+		if (error)
+		{
+			printf("Unable to create capture directory %s! %s\n", path_.c_str(), error.message().c_str());
+			return false;
+		}
+	}
+
+	// Every buffer is allocated up front, capturing never allocates.
+	frames_.resize(buffer_count);
+
+	for (int i = 0; i < buffer_count; ++i)
+	{
+		frames_[i].pixels.resize(static_cast<std::size_t>(pitch_) * height_);
+		frames_[i].index = 0;
+		free_frames_.push_back(i);
+	}
+
+	for (int i = 0; i < worker_count; ++i)
+	{
+		workers_.emplace_back(&FrameCapture::Work, this);
+	}
+
+	return true;
+}
+
+void FrameCapture::Capture(SDL_Renderer* renderer)
+{
+	const int slot = AcquireFrame();
+
+	if (slot < 0)
+	{
+		return;
+	}
+
+	// SDL 2 has no asynchronous readback, so this waits for the GPU to finish the frame. Only the encoding runs
+	// on the workers; the CPU rasterizer avoids the wait by handing its framebuffer to the other overload.
+	// Only the size the buffers were made for is read, in case the window has been resized since.
+	const SDL_Rect read_rect = { 0, 0, width_, height_ };
+	QueueFrame(slot, SDL_RenderReadPixels(renderer, &read_rect, SDL_PIXELFORMAT_ARGB8888, frames_[slot].pixels.data(), pitch_) == 0);
+}
+
+// The pixels have to be at least as large as the size given to Start.
+void FrameCapture::Capture(const void* pixels, int pitch)
+{
+	const int slot = AcquireFrame();
+
+	if (slot < 0)
+	{
+		return;
+	}
+
+	const std::uint8_t* source = static_cast<const std::uint8_t*>(pixels);
+	std::uint8_t* destination = frames_[slot].pixels.data();
+
+	for (int y = 0; y < height_; ++y)
+	{
+		std::memcpy(destination + static_cast<std::size_t>(y) * pitch_, source + static_cast<std::size_t>(y) * pitch, pitch_);
+	}
+
+	QueueFrame(slot, true);
+}
+
+int FrameCapture::AcquireFrame()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (free_frames_.empty())
+	{
+		// The encoders are behind, losing a frame is better than stalling the game loop.
+		++next_index_;
+		++dropped_;
+		return -1;
+	}
+
+	const int slot = free_frames_.back();
+	free_frames_.pop_back();
+	frames_[slot].index = next_index_++;
+
+	return slot;
+}
+
+void FrameCapture::QueueFrame(int slot, bool filled)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (filled)
+		{
+			queued_frames_.push_back(slot);
+		}
+		else
+		{
+			free_frames_.push_back(slot);
+			++dropped_;
+		}
+	}
+
+	if (filled)
+	{
+		frame_queued_.notify_one();
+	}
+}
+
+void FrameCapture::Stop()
+{
+	if (workers_.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	frame_queued_.notify_all();
+
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+
+	workers_.clear();
+
+	if (raw_file_ != nullptr)
+	{
+		std::fclose(raw_file_);
+		raw_file_ = nullptr;
+	}
+
+	printf("Capture: %llu frames encoded, %llu dropped\n", static_cast<unsigned long long>(encoded_), static_cast<unsigned long long>(dropped_));
+
+	if (format_ == CaptureFormat::RAW_VIDEO)
+	{
+		printf("Capture: %s is %dx%d BGRA (ARGB8888 little endian) frames\n", path_.c_str(), width_, height_);
+	}
+}
+
+std::uint64_t FrameCapture::Dropped()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return dropped_;
+}
+
+void FrameCapture::Work()
+{
+	for (;;)
+	{
+		int slot = -1;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			frame_queued_.wait(lock, [this]()
+			{
+				return stopping_ || !queued_frames_.empty();
+			});
+
+			// Queued frames are still drained when stopping.
+			if (queued_frames_.empty())
+			{
+				return;
+			}
+
+			slot = queued_frames_.front();
+			queued_frames_.pop_front();
+		}
+
+		Encode(frames_[slot]);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			free_frames_.push_back(slot);
+			++encoded_;
+		}
+	}
+}
+
+void FrameCapture::Encode(const Frame& frame)
+{
+	if (format_ == CaptureFormat::RAW_VIDEO)
+	{
+		std::fwrite(frame.pixels.data(), 1, frame.pixels.size(), raw_file_);
+		return;
+	}
+
+	char file_path[512];
+	std::snprintf(file_path, sizeof(file_path), "%s/frame_%06llu.png", path_.c_str(), static_cast<unsigned long long>(frame.index));
+
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<std::uint8_t*>(frame.pixels.data()), width_, height_, 32, pitch_, SDL_PIXELFORMAT_ARGB8888);
+
+	if (surface == nullptr)
+	{
+		printf("Unable to wrap captured frame! SDL Error: %s\n", SDL_GetError());
+		return;
+	}
+
+	if (IMG_SavePNG(surface, file_path) != 0)
+	{
+		printf("Unable to save %s! SDL_image Error: %s\n", file_path, IMG_GetError());
+	}
+
+	SDL_FreeSurface(surface);
+}
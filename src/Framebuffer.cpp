@@ -0,0 +1,214 @@
+#include "Framebuffer.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline Uint32 BlendPixel(Uint32 source, Uint32 destination)
+{
+	const Uint32 alpha = source >> 24;
+
+	if (alpha == 0xFF)
+	{
+		return source;
+	}
+
+	if (alpha == 0)
+	{
+		return destination;
+	}
+
+	const Uint32 inverse = 0xFF - alpha;
+	const Uint32 r = (((source >> 16) & 0xFF) * alpha + ((destination >> 16) & 0xFF) * inverse) / 0xFF;
+	const Uint32 g = (((source >> 8) & 0xFF) * alpha + ((destination >> 8) & 0xFF) * inverse) / 0xFF;
+	const Uint32 b = ((source & 0xFF) * alpha + (destination & 0xFF) * inverse) / 0xFF;
+
+	return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+Framebuffer::Framebuffer(int width, int height) : 
+	width_(width), 
+	height_(height), 
+	pixels_(static_cast<std::size_t>(width) * height, 0xFF000000), 
+	row_(width), 
+	clip_({ 0, 0, width, height })
+{
+}
+
+Framebuffer::~Framebuffer()
+{
+}
+
+void Framebuffer::SetClip(const SDL_Rect* clip)
+{
+	const SDL_Rect bounds = { 0, 0, width_, height_ };
+
+	if (clip == nullptr || !SDL_IntersectRect(clip, &bounds, &clip_))
+	{
+		clip_ = clip == nullptr ? bounds : SDL_Rect{ 0, 0, 0, 0 };
+	}
+}
+
+void Framebuffer::Clear(Uint32 color)
+{
+	std::fill(pixels_.begin(), pixels_.end(), color);
+}
+
+void Framebuffer::FillRect(const SDL_Rect& rect, Uint32 color)
+{
+	SDL_Rect visible;
+
+	if (!SDL_IntersectRect(&rect, &clip_, &visible))
+	{
+		return;
+	}
+
+	for (int y = visible.y; y < visible.y + visible.h; ++y)
+	{
+		std::fill_n(&pixels_[static_cast<std::size_t>(y) * width_ + visible.x], visible.w, color);
+	}
+}
+
+void Framebuffer::BlendRect(const SDL_Rect& rect, Uint32 color)
+{
+	SDL_Rect visible;
+
+	if (!SDL_IntersectRect(&rect, &clip_, &visible))
+	{
+		return;
+	}
+
+	for (int y = visible.y; y < visible.y + visible.h; ++y)
+	{
+		Uint32* destination = &pixels_[static_cast<std::size_t>(y) * width_ + visible.x];
+
+		for (int x = 0; x < visible.w; ++x)
+		{
+			destination[x] = BlendPixel(color, destination[x]);
+		}
+	}
+}
+
+void Framebuffer::Blit(const SDL_Surface* source, const SDL_Rect& source_rect, const SDL_Rect& destination)
+{
+	SDL_Rect visible;
+
+	if (destination.w <= 0 || destination.h <= 0 || !SDL_IntersectRect(&destination, &clip_, &visible))
+	{
+		return;
+	}
+
+	const Uint32* source_pixels = static_cast<const Uint32*>(source->pixels);
+	const int source_pitch = source->pitch / static_cast<int>(sizeof(Uint32));
+	const int skipped_x = visible.x - destination.x;
+
+	int stretched_row = -1;
+
+	for (int y = visible.y; y < visible.y + visible.h; ++y)
+	{
+		// Nearest-neighbor mapping, exact in integers so integer scales repeat every source pixel the same number of times.
+		const int source_y = source_rect.y + (y - destination.y) * source_rect.h / destination.h;
+		const Uint32* source_row = source_pixels + source_y * source_pitch + source_rect.x;
+		const Uint32* span = source_row + skipped_x;
+
+		if (source_rect.w != destination.w)
+		{
+			// A scaled source row is stretched once and reused for every destination row it covers.
+			if (source_y != stretched_row)
+			{
+				int source_x = skipped_x * source_rect.w / destination.w;
+				int error = skipped_x * source_rect.w % destination.w;
+
+				for (int x = 0; x < visible.w; ++x)
+				{
+					row_[x] = source_row[source_x];
+
+					source_x += source_rect.w / destination.w;
+					error += source_rect.w % destination.w;
+
+					if (error >= destination.w)
+					{
+						error -= destination.w;
+						++source_x;
+					}
+				}
+
+				stretched_row = source_y;
+			}
+
+			span = row_.data();
+		}
+
+		CompositeSpan(span, &pixels_[static_cast<std::size_t>(y) * width_ + visible.x], visible.w);
+	}
+}
+
+const Uint32* Framebuffer::Pixels(int x, int y) const
+{
+	return &pixels_[static_cast<std::size_t>(y) * width_ + x];
+}
+
+int Framebuffer::Width() const
+{
+	return width_;
+}
+
+int Framebuffer::Height() const
+{
+	return height_;
+}
+
+int Framebuffer::Pitch() const
+{
+	return width_ * static_cast<int>(sizeof(Uint32));
+}
+
+void Framebuffer::CompositeSpan(const Uint32* source, Uint32* destination, int count)
+{
+	int i = 0;
+
+#if defined(__SSE2__)
+	// Sprites are opaque except for the transparent color key, so four pixels at a time are either copied,
+	// skipped or selected per pixel; only anti-aliased text edges fall through to the scalar blend.
+	const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		const __m128i alpha = _mm_and_si128(pixels, alpha_mask);
+		const __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+		const int opaque_bits = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alpha_mask));
+		const int transparent_bits = _mm_movemask_epi8(transparent);
+
+		if (opaque_bits == 0xFFFF)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), pixels);
+		}
+		else if (transparent_bits == 0xFFFF)
+		{
+			continue;
+		}
+		else if ((opaque_bits | transparent_bits) == 0xFFFF)
+		{
+			__m128i* target = reinterpret_cast<__m128i*>(destination + i);
+			const __m128i background = _mm_loadu_si128(target);
+			_mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(transparent, background), _mm_andnot_si128(transparent, pixels)));
+		}
+		else
+		{
+			for (int j = i; j < i + 4; ++j)
+			{
+				destination[j] = BlendPixel(source[j], destination[j]);
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		destination[i] = BlendPixel(source[i], destination[i]);
+	}
+}
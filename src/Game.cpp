@@ -4,29 +4,69 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <string>
+#include <thread>
 	
-Game::Game() : 
+Game::Game(const Options& options) : 
+	options_(options), 
 	initialized_(false), 
 	running_(false), 
-	ground_scrolling_offset_(0), 
+	ground_scrolling_offset_(Fixed::FromInt(0)), 
+	previous_ground_scrolling_offset_(Fixed::FromInt(0)), 
+	scroll_per_tick_(Fixed::PerTick(constants::scrolling_speed, options.tick_rate)), 
+	tick_count_(0), 
+	ticks_run_(0), 
+	displayed_score_(-1), 
+	pixels_redrawn_(0), 
+	frames_skipped_(0), 
+	native_scale_(1), 
+	resets_(0), 
 	player_(nullptr), 
-	background_texture_(std::make_unique<Texture>()), 
-	sprites_texture_(std::make_unique<Texture>()), 
-	score_info_(std::make_unique<Texture>()), 
+	atlas_(std::make_unique<TextureAtlas>()), 
+	score_info_(std::make_unique<NumberLabel>()), 
 	game_over_info_(std::make_unique<Texture>()), 
+	damage_tracker_(nullptr), 
+	scene_target_(nullptr), 
+	framebuffer_(nullptr), 
+	framebuffer_texture_(nullptr), 
+	frame_capture_(nullptr), 
+	autopilot_(nullptr), 
+	metrics_log_(nullptr), 
+	metrics_export_(nullptr), 
+	music_(nullptr), 
+	clock_(1.0L / options.tick_rate), 
+	snapshots_(constants::rewind_seconds * options.tick_rate), 
+	checksum_log_(nullptr), 
+	snapshot_time_(0.0), 
+	snapshot_count_(0), 
+	particle_update_time_(0.0), 
+	particle_render_time_(0.0), 
 	game_over_(false), 
 	score_(0), 
-	scrolling_speed_(10), 
+	scrolling_speed_(constants::scrolling_speed), 
+	tick_rate_(options.tick_rate), 
+	tick_length_(1.0f / options.tick_rate), 
+	render_alpha_(1.0f), 
+	gravity_per_tick_(Fixed::PerTickSquared(constants::gravity, options.tick_rate)), 
+	jump_velocity_per_tick_(Fixed::PerTick(constants::jump_velocity, options.tick_rate)), 
 	background_without_ground_h_(640), 
-	mt_(std::random_device{}()), 
-	random_index_(0, 3), 
+	rightmost_obstacle_x_(0), 
+	rightmost_bonus_item_x_(0), 
+	seed_(options.seed), 
 	font_(nullptr), 
 	window_(nullptr), 
 	renderer_(nullptr)
 {
+	clock_.SetTimeScale(options_.time_scale);
+	clock_.SetTicksPerFrame(options_.ticks_per_frame);
+	clock_.SetMaxFrameTime(constants::max_catch_up_ms / 1000.0L);
+	clock_.SetUncapped(options_.uncapped);
+
 	initialized_ = Initialize();
 }
 
@@ -48,7 +88,8 @@ bool Game::Initialize()
 		printf("%s\n", "Warning: Texture filtering is not enabled!");
 	}
 
-	window_ = SDL_CreateWindow(constants::game_title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, constants::screen_width, constants::screen_height, SDL_WINDOW_SHOWN);
+	const Uint32 window_flags = options_.low_res ? SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE : SDL_WINDOW_SHOWN;
+	window_ = SDL_CreateWindow(constants::game_title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, constants::screen_width, constants::screen_height, window_flags);
 
 	if (window_ == nullptr)
 	{
@@ -56,7 +97,15 @@ bool Game::Initialize()
 		return false;
 	}
 
-	renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
+	Uint32 renderer_flags = options_.software_renderer ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+
+	if (options_.cpu_raster)
+	{
+		// The renderer only has to show one streaming texture per frame, whichever one SDL can create will do.
+		renderer_flags = 0;
+	}
+
+	renderer_ = SDL_CreateRenderer(window_, -1, renderer_flags);
 
 	if (renderer_ == nullptr)
 	{
@@ -66,6 +115,126 @@ bool Game::Initialize()
 
 	SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
 
+	if (options_.low_res)
+	{
+		native_scale_ = constants::native_scale;
+	}
+
+	if (options_.cpu_raster)
+	{
+		// The framebuffer keeps its pixels between frames, so damage tracking needs no separate scene target.
+		framebuffer_ = std::make_unique<Framebuffer>(constants::screen_width, constants::screen_height);
+
+		if (!options_.headless)
+		{
+			framebuffer_texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, constants::screen_width, constants::screen_height);
+
+			if (framebuffer_texture_ == nullptr)
+			{
+				printf("Framebuffer texture could not be created! SDL Error: %s\n", SDL_GetError());
+				return false;
+			}
+		}
+
+		atlas_->texture_.framebuffer_ = framebuffer_.get();
+		game_over_info_->framebuffer_ = framebuffer_.get();
+
+		if (options_.damage_tracking)
+		{
+			damage_tracker_ = std::make_unique<DamageTracker>(constants::screen_width, constants::screen_height);
+		}
+	}
+	else if (options_.damage_tracking || options_.low_res)
+	{
+		scene_target_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, constants::screen_width / native_scale_, constants::screen_height / native_scale_);
+
+		if (scene_target_ == nullptr)
+		{
+			printf("Scene target could not be created, rendering straight to the window! SDL Error: %s\n", SDL_GetError());
+			native_scale_ = 1;
+		}
+		else if (options_.damage_tracking)
+		{
+			damage_tracker_ = std::make_unique<DamageTracker>(constants::screen_width, constants::screen_height);
+		}
+	}
+
+	if (!options_.capture_png_dir.empty() || !options_.capture_raw_path.empty())
+	{
+		const bool raw = !options_.capture_raw_path.empty();
+		const int worker_count = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+
+		// The CPU rasterizer's frames are copied out of the framebuffer, which keeps the game's size whatever the window's
+		// drawable is. Frames read back from the renderer have the drawable's size.
+		int capture_w = 0;
+		int capture_h = 0;
+
+		if (framebuffer_ != nullptr)
+		{
+			capture_w = framebuffer_->Width();
+			capture_h = framebuffer_->Height();
+		}
+		else if (SDL_GetRendererOutputSize(renderer_, &capture_w, &capture_h) != 0)
+		{
+			printf("Unable to query renderer output size! SDL Error: %s\n", SDL_GetError());
+			return false;
+		}
+
+		frame_capture_ = std::make_unique<FrameCapture>(raw ? CaptureFormat::RAW_VIDEO : CaptureFormat::PNG_SEQUENCE, raw ? options_.capture_raw_path : options_.capture_png_dir);
+
+		if (!frame_capture_->Start(capture_w, capture_h, 8, worker_count))
+		{
+			printf("%s\n", "Frame capture could not be started!");
+			return false;
+		}
+	}
+
+	if (options_.stats)
+	{
+		SDL_RendererInfo renderer_info;
+		SDL_GetRendererInfo(renderer_, &renderer_info);
+
+		printf("Renderer: %s%s\n", framebuffer_ != nullptr ? "CPU rasterizer, presented by " : "", renderer_info.name);
+		printf("Collision kernel: %s\n", RectBatch::KernelName());
+		printf("Seed: %llu\n", static_cast<unsigned long long>(seed_));
+	}
+
+	if (options_.autopilot)
+	{
+		autopilot_ = std::make_unique<Autopilot>(this, options_.auto_reset);
+	}
+
+	if (!options_.metrics_path.empty())
+	{
+		metrics_log_ = std::make_unique<MetricsLog>(options_.metrics_path);
+
+		if (!metrics_log_->Open())
+		{
+			return false;
+		}
+	}
+
+	if (!options_.metrics_shm_name.empty())
+	{
+		metrics_export_ = std::make_unique<MetricsExport>(options_.metrics_shm_name);
+
+		if (!metrics_export_->Open())
+		{
+			return false;
+		}
+	}
+
+	if (!options_.checksum_log_path.empty())
+	{
+		checksum_log_ = std::fopen(options_.checksum_log_path.c_str(), "w");
+
+		if (checksum_log_ == nullptr)
+		{
+			printf("Unable to open checksum log %s!\n", options_.checksum_log_path.c_str());
+			return false;
+		}
+	}
+
 	constexpr int img_flags = IMG_INIT_PNG;
 
 	if (!(IMG_Init(img_flags) & img_flags))
@@ -86,13 +255,59 @@ bool Game::Initialize()
 		return false;
 	}
 
+	// The default tracks are not part of the repository, --music names one to stream.
+	if (!options_.no_music && std::filesystem::exists(options_.music_path))
+	{
+		music_ = std::make_unique<Music>();
+
+		if (music_->Open())
+		{
+			music_->CrossFade(options_.music_path.c_str(), 0);
+		}
+		else
+		{
+			music_.reset();
+		}
+	}
+
+	if (!InitAssets())
+	{
+		return false;
+	}
+
+	particles_ = std::make_unique<ParticleSystem>(atlas_.get(), std::max<std::size_t>(constants::particle_capacity, options_.particle_stress), RandomStream::Create(seed_, RandomSubsystem::PARTICLES, 0));
+
 	SpawnObjects();
+	SaveSnapshot(snapshots_.Push());
 
-	return InitAssets();
+	return true;
 }
 
 void Game::Finalize()
 {
+	if (checksum_log_ != nullptr)
+	{
+		std::fclose(checksum_log_);
+		checksum_log_ = nullptr;
+	}
+
+	if (frame_capture_ != nullptr)
+	{
+		frame_capture_->Stop();
+	}
+
+	if (scene_target_ != nullptr)
+	{
+		SDL_DestroyTexture(scene_target_);
+		scene_target_ = nullptr;
+	}
+
+	if (framebuffer_texture_ != nullptr)
+	{
+		SDL_DestroyTexture(framebuffer_texture_);
+		framebuffer_texture_ = nullptr;
+	}
+
 	SDL_DestroyWindow(window_);
 	window_ = nullptr;
 
@@ -102,6 +317,11 @@ void Game::Finalize()
 	TTF_CloseFont(font_);
 	font_ = nullptr;
 
+	if (music_ != nullptr)
+	{
+		music_->Close();
+	}
+
 	IMG_Quit();
 	SDL_Quit();
 	TTF_Quit();
@@ -110,8 +330,26 @@ void Game::Finalize()
 
 bool Game::InitAssets()
 {
-	background_texture_->LoadFromPath(renderer_, "res/gfx/background.png");
-	sprites_texture_->LoadFromPath(renderer_, "res/gfx/objects.png");
+	if (!atlas_->Load(renderer_))
+	{
+		printf("%s\n", "Failed to build texture atlas!");
+		return false;
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		player_masks_[i] = Player::BuildMask(*atlas_, i);
+	}
+
+	for (int i = 0; i < obstacle_type_count; ++i)
+	{
+		obstacle_masks_[i] = Obstacle::BuildMask(*atlas_, static_cast<ObstacleType>(i), constants::obstacle_scale);
+	}
+
+	for (int i = 0; i < bonus_item_type_count; ++i)
+	{
+		bonus_item_masks_[i] = BonusItem::BuildMask(*atlas_, static_cast<BonusItemType>(i), constants::bonus_item_scale);
+	}
 
 	font_ = TTF_OpenFont("res/font/font.ttf", 28);
 
@@ -124,6 +362,12 @@ bool Game::InitAssets()
 	SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
 	game_over_info_->LoadFromText(renderer_, font_, "GAME OVER. Press 'R' to reset. ", text_color);
 
+	if (!score_info_->Load(renderer_, font_, "Score: ", text_color, framebuffer_.get()))
+	{
+		printf("%s\n", "Failed to render score text!");
+		return false;
+	}
+
 	UpdateScoreText();
 
 	return true;
@@ -131,81 +375,315 @@ bool Game::InitAssets()
 
 void Game::SpawnObjects()
 {
-	player_ = std::make_unique<Player>(this);
+	// Objects are created for the first game and reset in place for every later one, so a new game allocates nothing.
+	if (player_ == nullptr)
+	{
+		player_ = std::make_unique<Player>(this, atlas_.get());
+	}
+	else
+	{
+		player_->Reset();
+	}
 
-	constexpr float scale = 2.0f;
 	constexpr int distances[4] = { 400, 600, 800, 1000 };
 
-	obstacles_.emplace_back(std::make_unique<Obstacle>(this, sprites_texture_.get(), static_cast<ObstacleType>(random_index_(mt_)), 1400, scale));
+	// Every entity draws from its own stream of this game's seed, so the world only depends on the seed and not on
+	// the order entities happen to ask for numbers in.
+	const std::uint64_t world_seed = RandomStream::At(seed_, resets_);
+
+	int x = 1400;
 
-	for (std::size_t i = 1; i < 5; ++i)
+	for (int i = 0; i < constants::obstacle_count; ++i)
 	{
-		obstacles_.emplace_back(std::make_unique<Obstacle>(this, sprites_texture_.get(), static_cast<ObstacleType>(random_index_(mt_)), obstacles_.at(i - 1)->bounding_box_.x + distances[random_index_(mt_)], scale));
+		RandomStream random = RandomStream::Create(world_seed, RandomSubsystem::OBSTACLES, i);
+		const ObstacleType type = static_cast<ObstacleType>(random.Below(obstacle_type_count));
+
+		if (i > 0)
+		{
+			x += distances[random.Below(4)];
+		}
+
+		if (i < static_cast<int>(obstacles_.size()))
+		{
+			obstacles_[i]->Reset(type, x, random);
+		}
+		else
+		{
+			obstacles_.emplace_back(std::make_unique<Obstacle>(this, atlas_.get(), type, x, constants::obstacle_scale, random));
+		}
 	}
 
-	bonus_items_.emplace_back(std::make_unique<BonusItem>(this, sprites_texture_.get(), BonusItemType::MONEY, 1400, scale * 2));
+	x = 1400;
 
-	for (std::size_t i = 1; i < 5; ++i)
+	for (int i = 0; i < constants::bonus_item_count; ++i)
 	{
-		bonus_items_.emplace_back(std::make_unique<BonusItem>(this, sprites_texture_.get(), BonusItemType::MONEY, bonus_items_.at(i - 1)->bounding_box_.x + distances[random_index_(mt_)], scale * 2));
+		RandomStream random = RandomStream::Create(world_seed, RandomSubsystem::BONUS_ITEMS, i);
+
+		if (i > 0)
+		{
+			x += distances[random.Below(4)];
+		}
+
+		if (i < static_cast<int>(bonus_items_.size()))
+		{
+			bonus_items_[i]->Reset(BonusItemType::MONEY, x, random);
+		}
+		else
+		{
+			bonus_items_.emplace_back(std::make_unique<BonusItem>(this, atlas_.get(), BonusItemType::MONEY, x, constants::bonus_item_scale, random));
+		}
 	}
 }
 
-void Game::Run()
+bool Game::Run()
 {
 	if (!initialized_)
 	{
 		Finalize();
-		return;
+		return false;
 	}
 
 	running_ = true;
 
-	constexpr long double ms = 1.0 / 60.0;
+	// Loading is allowed to allocate, counting starts with the first frame.
+	if (options_.alloc_stats)
+	{
+		AllocationTracker::Enable();
+	}
+
+	bool within_budget = true;
+	std::uint64_t frame = 0;
+	AllocCounts second_allocations[static_cast<int>(AllocPhase::COUNT)];
+
+	const std::uint64_t frequency = SDL_GetPerformanceFrequency();
 	std::uint64_t last_time = SDL_GetPerformanceCounter();
-	long double delta = 0.0;
 
 	double timer = SDL_GetTicks();
 
-	int frames = 0;
-	int ticks = 0;
+	FrameMetrics metrics;
+	double render_time = 0.0;
+	double music_cpu_seconds = 0.0;
 
 	while (running_)
 	{
 		const std::uint64_t now = SDL_GetPerformanceCounter();
-		const long double elapsed = static_cast<long double>(now - last_time) / static_cast<long double>(SDL_GetPerformanceFrequency());
+		const long double elapsed = static_cast<long double>(now - last_time) / static_cast<long double>(frequency);
 
 		last_time = now;
-		delta += elapsed;
 
+		metrics.frame_time_total += static_cast<double>(elapsed);
+		metrics.frame_time_max = std::max(metrics.frame_time_max, static_cast<double>(elapsed));
+
+		AllocationTracker::SetPhase(AllocPhase::EVENTS);
 		HandleEvents();
 
-		while (delta >= ms)
+		AllocationTracker::SetPhase(AllocPhase::TICK);
+
+		const int ticks_before = metrics.ticks;
+
+		if (clock_.Uncapped())
+		{
+			// Simulate as many ticks as fit into one 60 Hz frame, then show where the game got to.
+			const std::uint64_t deadline = now + frequency / 60;
+
+			do
+			{
+				Tick();
+				++metrics.ticks;
+			}
+			while (running_ && SDL_GetPerformanceCounter() < deadline);
+
+			render_alpha_ = 1.0f;
+		}
+		else
+		{
+			const int ticks = clock_.Advance(elapsed);
+
+			for (int i = 0; i < ticks && running_; ++i)
+			{
+				Tick();
+				++metrics.ticks;
+			}
+
+			// Rendering lags one tick behind and blends the last two ticks by the time left over in the accumulator.
+			render_alpha_ = clock_.Alpha();
+		}
+
+		AllocationTracker::SetPhase(AllocPhase::RENDER);
+
+		const std::uint64_t render_start = SDL_GetPerformanceCounter();
+
+		if (Render())
+		{
+			++metrics.frames;
+		}
+		else
+		{
+			// Nothing changed on screen, so there is no point in spinning through the loop at full speed.
+			SDL_Delay(1);
+		}
+
+		render_time += static_cast<double>(SDL_GetPerformanceCounter() - render_start) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+		AllocationTracker::SetPhase(AllocPhase::OTHER);
+
+		if (metrics_export_ != nullptr)
 		{
-			Tick();	
-			delta -= ms;
-			++ticks;
+			PublishMetrics(static_cast<double>(elapsed), metrics.ticks - ticks_before);
 		}
 
-		//printf("%Lf\n", delta / ms);
-		Render();
-		++frames;
+		Texture::draw_calls_ = 0;
+
+		if (AllocationTracker::Enabled())
+		{
+			const AllocCounts frame_allocations = AllocationTracker::FrameTotal();
+			metrics.allocations += frame_allocations.allocations;
+			metrics.allocated_bytes += frame_allocations.bytes;
+
+			if (!CheckAllocations(frame++, second_allocations))
+			{
+				within_budget = false;
+				running_ = false;
+			}
+		}
 
 		if (SDL_GetTicks() - timer > 1000)
 		{
 			timer += 1000;
-			++score_;
 
-			if (score_ % 50 == 0)
+			if (options_.stats)
+			{
+				const long full_area = static_cast<long>(constants::screen_width) * constants::screen_height;
+				const long redrawn = metrics.frames > 0 ? pixels_redrawn_ / metrics.frames : 0;
+				printf("Frames: %d, Skipped: %d, Ticks: %d, Render: %.3f ms/frame, Redrawn: %ld px/frame (%.1f%% of full)", metrics.frames, frames_skipped_, metrics.ticks, metrics.frames > 0 ? 1000.0 * render_time / metrics.frames : 0.0, redrawn, 100.0 * redrawn / full_area);
+
+				if (metrics.ticks > 0 && metrics.frames > 0)
+				{
+					printf(", Particles: %zu (update %.3f ms/tick, draw %.3f ms/frame)", particles_->Count(), 1000.0 * particle_update_time_ / metrics.ticks, 1000.0 * particle_render_time_ / metrics.frames);
+				}
+
+				if (clock_.DroppedTicks() > 0)
+				{
+					printf(", Ticks dropped: %llu", static_cast<unsigned long long>(clock_.DroppedTicks()));
+				}
+
+				if (snapshot_count_ > 0)
+				{
+					printf(", Snapshot: %.0f ns", 1e9 * snapshot_time_ / snapshot_count_);
+				}
+
+				if (frame_capture_ != nullptr)
+				{
+					printf(", Capture dropped: %llu", static_cast<unsigned long long>(frame_capture_->Dropped()));
+				}
+
+				if (music_ != nullptr)
+				{
+					const double cpu_seconds = music_->DecodeCpuSeconds();
+					printf(", Music: %llu underruns, decode %.2f%% CPU", static_cast<unsigned long long>(music_->Underruns()), 100.0 * (cpu_seconds - music_cpu_seconds));
+					music_cpu_seconds = cpu_seconds;
+				}
+
+				if (AllocationTracker::Enabled() && metrics.frames > 0)
+				{
+					printf(", Allocs/frame:");
+
+					for (int i = 0; i < static_cast<int>(AllocPhase::COUNT); ++i)
+					{
+						const AllocCounts& counts = second_allocations[i];
+						printf(" %s %.1f (%.0f B, %.1f surfaces, %.1f textures)", AllocationTracker::PhaseName(static_cast<AllocPhase>(i)), static_cast<double>(counts.allocations) / metrics.frames, static_cast<double>(counts.bytes) / metrics.frames, static_cast<double>(counts.surfaces) / metrics.frames, static_cast<double>(counts.textures) / metrics.frames);
+					}
+				}
+
+				printf("\n");
+			}
+
+			if (metrics_log_ != nullptr)
+			{
+				metrics_log_->Write(metrics, score_, scrolling_speed_, resets_);
+			}
+
+			metrics = FrameMetrics();
+			render_time = 0.0;
+			pixels_redrawn_ = 0;
+			frames_skipped_ = 0;
+			snapshot_time_ = 0.0;
+			snapshot_count_ = 0;
+			particle_update_time_ = 0.0;
+			particle_render_time_ = 0.0;
+
+			for (AllocCounts& counts : second_allocations)
 			{
-				++scrolling_speed_;
+				counts = AllocCounts();
 			}
+		}
+	}
+
+	if (options_.exit_after_ticks > 0 && ticks_run_ == options_.exit_after_ticks)
+	{
+		Snapshot final_state;
+		SaveSnapshot(final_state);
+		printf("Checksum after %llu ticks: %016llx\n", static_cast<unsigned long long>(ticks_run_), static_cast<unsigned long long>(final_state.Checksum()));
+	}
+
+	return within_budget;
+}
+
+void Game::PublishMetrics(double frame_time, int ticks)
+{
+	const AllocCounts allocations = AllocationTracker::FrameTotal();
+
+	MetricsSample sample;
+	sample.obstacles = static_cast<std::uint32_t>(obstacles_.size());
+	sample.bonus_items = static_cast<std::uint32_t>(bonus_items_.size());
+	sample.particles = static_cast<std::uint32_t>(particles_->Count());
+	sample.draw_calls = static_cast<std::uint32_t>(Texture::draw_calls_);
+	sample.allocations = static_cast<std::uint32_t>(allocations.allocations);
+	sample.surfaces = static_cast<std::uint32_t>(allocations.surfaces);
+	sample.textures = static_cast<std::uint32_t>(allocations.textures);
+	sample.score = score_;
+	sample.scrolling_speed = scrolling_speed_;
+	sample.game_over = game_over_;
+
+	metrics_export_->Publish(sample, frame_time, ticks);
+}
+
+bool Game::CheckAllocations(std::uint64_t frame, AllocCounts* second_counts)
+{
+	std::uint64_t frame_total = 0;
+
+	for (int i = 0; i < static_cast<int>(AllocPhase::COUNT); ++i)
+	{
+		const AllocCounts& counts = AllocationTracker::Frame(static_cast<AllocPhase>(i));
+
+		second_counts[i].allocations += counts.allocations;
+		second_counts[i].bytes += counts.bytes;
+		second_counts[i].frees += counts.frees;
+		second_counts[i].surfaces += counts.surfaces;
+		second_counts[i].textures += counts.textures;
+
+		frame_total += counts.allocations + counts.surfaces + counts.textures;
+	}
+
+	bool within_budget = true;
+
+	// The first frames still fill caches in SDL and the driver, the budget only applies to steady-state gameplay.
+	if (options_.alloc_budget >= 0 && frame >= constants::alloc_warmup_frames && frame_total > static_cast<std::uint64_t>(options_.alloc_budget))
+	{
+		printf("Allocation budget of %d exceeded in frame %llu with %llu allocations:\n", options_.alloc_budget, static_cast<unsigned long long>(frame), static_cast<unsigned long long>(frame_total));
 
-			//printf("Frames: %d, Ticks: %d\n", frames, ticks);
-			frames = 0;
-			ticks = 0;
+		for (int i = 0; i < static_cast<int>(AllocPhase::COUNT); ++i)
+		{
+			const AllocCounts& counts = AllocationTracker::Frame(static_cast<AllocPhase>(i));
+			printf("  %-7s %llu operator new (%llu B), %llu surfaces, %llu textures\n", AllocationTracker::PhaseName(static_cast<AllocPhase>(i)), static_cast<unsigned long long>(counts.allocations), static_cast<unsigned long long>(counts.bytes), static_cast<unsigned long long>(counts.surfaces), static_cast<unsigned long long>(counts.textures));
 		}
+
+		within_budget = false;
 	}
+
+	AllocationTracker::EndFrame();
+
+	return within_budget;
 }
 
 void Game::HandleEvents()
@@ -214,25 +692,66 @@ void Game::HandleEvents()
 
 	while (SDL_PollEvent(&e) != 0)
 	{
-		if (e.type == SDL_QUIT)
-		{
-			running_ = false;
-		}
+		HandleEvent(&e);
+	}
+}
 
-		if (game_over_ && e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_r)
-		{
-			Reset();
-		}
-		
-		if (!game_over_)
-		{
-			player_->HandleEvent(&e);
-		}
+void Game::HandleEvent(SDL_Event* e)
+{
+	if (e->type == SDL_QUIT)
+	{
+		running_ = false;
+	}
+
+	if (damage_tracker_ != nullptr && e->type == SDL_WINDOWEVENT && (e->window.event == SDL_WINDOWEVENT_EXPOSED || e->window.event == SDL_WINDOWEVENT_SIZE_CHANGED))
+	{
+		damage_tracker_->InvalidateAll();
+	}
+
+	if (game_over_ && e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_r)
+	{
+		Reset();
+	}
+	
+	if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_BACKSPACE)
+	{
+		Rewind(tick_rate_);
+	}
+
+	if (game_over_ && e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_c)
+	{
+		Rewind(3 * tick_rate_);
+	}
+
+	if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_p)
+	{
+		clock_.TogglePause();
+	}
+
+	if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_n)
+	{
+		clock_.Step();
+	}
+
+	if (!game_over_)
+	{
+		player_->HandleEvent(e);
 	}
 }
 
 void Game::Tick()
 {
+	// The tick still runs to completion, the loop stops before the next one.
+	if (++ticks_run_ == options_.exit_after_ticks)
+	{
+		running_ = false;
+	}
+
+	if (autopilot_ != nullptr)
+	{
+		autopilot_->Tick(*player_);
+	}
+
 	if (game_over_)
 	{
 		return;
@@ -240,15 +759,47 @@ void Game::Tick()
 
 	player_->Tick();
 
+	// Score and difficulty follow simulated time, so they scale with the clock instead of the wall.
+	++tick_count_;
+
+	if (tick_count_ % tick_rate_ == 0)
+	{
+		++score_;
+
+		if (score_ % 50 == 0)
+		{
+			SetScrollingSpeed(std::min(constants::max_scrolling_speed, scrolling_speed_ + constants::scrolling_speed_step));
+		}
+	}
+
 	UpdateScoreText();
 
-	ground_scrolling_offset_ -= scrolling_speed_;
+	previous_ground_scrolling_offset_ = ground_scrolling_offset_;
+	ground_scrolling_offset_ -= ScrollPerTick();
 
-	if (ground_scrolling_offset_ < -constants::screen_width)
+	if (ground_scrolling_offset_ < Fixed::FromInt(-constants::screen_width))
 	{
-		ground_scrolling_offset_ = 0;
+		ground_scrolling_offset_ += Fixed::FromInt(constants::screen_width);
+		previous_ground_scrolling_offset_ += Fixed::FromInt(constants::screen_width);
 	}
 
+	// Respawns line up behind the rightmost entity as it stands after this tick's scroll. It is taken before any entity
+	// moves, so where one lands does not depend on which siblings happened to be updated before it.
+	const auto rightmost_x = [this](const auto& entities)
+	{
+		int x = entities.front()->bounding_box_.x;
+
+		for (const auto& entity : entities)
+		{
+			x = std::max(x, entity->bounding_box_.x);
+		}
+
+		return (Fixed::FromInt(x) - ScrollPerTick()).Floor();
+	};
+
+	rightmost_obstacle_x_ = rightmost_x(obstacles_);
+	rightmost_bonus_item_x_ = rightmost_x(bonus_items_);
+
 	for (const std::unique_ptr<Obstacle>& obstacle : obstacles_)
 	{
 		obstacle->Tick();
@@ -258,34 +809,179 @@ void Game::Tick()
 	{
 		bonus_item->Tick();
 	}
+
+	const std::uint64_t particles_start = SDL_GetPerformanceCounter();
+
+	if (options_.particle_stress > 0)
+	{
+		const SDL_Rect stress_area = { 0, 0, constants::screen_width, background_without_ground_h_ };
+		particles_->Saturate(ParticleEmitter::SPARKLE, options_.particle_stress, stress_area);
+	}
+
+	particles_->Tick(scrolling_speed_, tick_length_);
+	particle_update_time_ += static_cast<double>(SDL_GetPerformanceCounter() - particles_start) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+	const std::uint64_t snapshot_start = SDL_GetPerformanceCounter();
+	Snapshot& snapshot = snapshots_.Push();
+	SaveSnapshot(snapshot);
+	snapshot_time_ += static_cast<double>(SDL_GetPerformanceCounter() - snapshot_start) / static_cast<double>(SDL_GetPerformanceFrequency());
+	++snapshot_count_;
+
+	if (checksum_log_ != nullptr)
+	{
+		std::fprintf(checksum_log_, "%016llx\n", static_cast<unsigned long long>(snapshot.Checksum()));
+	}
 }
 
-void Game::Render()
+bool Game::Render()
 {
+	if (damage_tracker_ != nullptr)
+	{
+		TrackScene();
+		damage_tracker_->Resolve();
+		damage_tracker_->Spread(particles_->Bounds());
+
+		if (damage_tracker_->DirtyRects().empty())
+		{
+			++frames_skipped_;
+			return false;
+		}
+	}
+
+	if (framebuffer_ != nullptr)
+	{
+		Rasterize();
+		Present();
+
+		return true;
+	}
+
 	SDL_RenderSetViewport(renderer_, NULL);
 	SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0xFF);
 
-	SDL_RenderClear(renderer_);
+	if (scene_target_ != nullptr)
+	{
+		// The target is native_scale_ times smaller than the game's coordinates, the render scale maps one onto the other.
+		SDL_SetRenderTarget(renderer_, scene_target_);
+		SDL_RenderSetScale(renderer_, 1.0f / native_scale_, 1.0f / native_scale_);
+	}
+
+	const long native_area = static_cast<long>(native_scale_) * native_scale_;
+
+	if (damage_tracker_ != nullptr)
+	{
+		// The scene target keeps last frame's pixels, so only the dirty rects have to be cleared and drawn again.
+		for (const SDL_Rect& dirty_rect : damage_tracker_->DirtyRects())
+		{
+			SDL_RenderSetClipRect(renderer_, &dirty_rect);
+			SDL_RenderFillRect(renderer_, &dirty_rect);
+			RenderScene();
+		}
+
+		SDL_RenderSetClipRect(renderer_, nullptr);
+		RenderParticles();
+		pixels_redrawn_ += damage_tracker_->DirtyArea() / native_area;
+	}
+	else
+	{
+		SDL_RenderClear(renderer_);
+		RenderScene();
+		RenderParticles();
+		pixels_redrawn_ += static_cast<long>(constants::screen_width) * constants::screen_height / native_area;
+	}
+
+	if (scene_target_ != nullptr)
+	{
+		SDL_SetRenderTarget(renderer_, nullptr);
+		UpscaleScene();
+	}
+
+	RenderHud();
+
+	SDL_RenderSetViewport(renderer_, NULL);
+	SDL_RenderSetScale(renderer_, 1.0f, 1.0f);
+
+	Present();
+
+	return true;
+}
+
+void Game::Rasterize()
+{
+	constexpr Uint32 black = 0xFF000000;
+
+	if (damage_tracker_ != nullptr)
+	{
+		for (const SDL_Rect& dirty_rect : damage_tracker_->DirtyRects())
+		{
+			framebuffer_->SetClip(&dirty_rect);
+			framebuffer_->FillRect(dirty_rect, black);
+			RenderScene();
+		}
+
+		framebuffer_->SetClip(nullptr);
+		RenderParticles();
+
+		// The HUD lives in the same persistent pixels as the scene, so it is redrawn on top of it.
+		for (const SDL_Rect& dirty_rect : damage_tracker_->DirtyRects())
+		{
+			framebuffer_->SetClip(&dirty_rect);
+			RenderHud();
+		}
+
+		framebuffer_->SetClip(nullptr);
+		pixels_redrawn_ += damage_tracker_->DirtyArea();
+	}
+	else
+	{
+		framebuffer_->Clear(black);
+		RenderScene();
+		RenderParticles();
+		RenderHud();
+		pixels_redrawn_ += static_cast<long>(constants::screen_width) * constants::screen_height;
+	}
+}
+
+void Game::UpscaleScene()
+{
+	int output_w = 0;
+	int output_h = 0;
+	SDL_GetRendererOutputSize(renderer_, &output_w, &output_h);
+
+	const int target_w = constants::screen_width / native_scale_;
+	const int target_h = constants::screen_height / native_scale_;
+	const int upscale = std::max(1, std::min(output_w / target_w, output_h / target_h));
+
+	const SDL_Rect scene_rect = { (output_w - target_w * upscale) / 2, (output_h - target_h * upscale) / 2, target_w * upscale, target_h * upscale };
+
+	if (scene_rect.w != output_w || scene_rect.h != output_h)
+	{
+		SDL_RenderClear(renderer_);
+	}
+
+	SDL_RenderCopy(renderer_, scene_target_, nullptr, &scene_rect);
+
+	// The HUD is drawn straight into the window at full resolution, in the same coordinates as the scene.
+	const float hud_scale = static_cast<float>(upscale) / native_scale_;
 
-	SDL_Rect background_clip;
-	background_clip.x = 0;
-	background_clip.y = 0;
-	background_clip.w = constants::screen_width;
-	background_clip.h = background_without_ground_h_;
+	SDL_RenderSetViewport(renderer_, &scene_rect);
+	SDL_RenderSetScale(renderer_, hud_scale, hud_scale);
+}
+
+void Game::RenderScene()
+{
+	SDL_Rect background_clip = atlas_->Clip(AtlasRegion::BACKGROUND, 0, 0, constants::screen_width, background_without_ground_h_);
+
+	atlas_->texture_.Render(renderer_, 0, 0, &background_clip);
 
-	background_texture_->Render(renderer_, 0, 0, &background_clip);
+	SDL_Rect ground_clip = atlas_->Clip(AtlasRegion::BACKGROUND, 0, background_without_ground_h_, constants::screen_width, constants::screen_height - background_without_ground_h_);
 
-	SDL_Rect ground_clip;
-	ground_clip.x = 0;
-	ground_clip.y = background_without_ground_h_;
-	ground_clip.w = constants::screen_width;
-	ground_clip.h = constants::screen_height - background_without_ground_h_;
+	const int ground_x = GroundX();
 
-	background_texture_->Render(renderer_, ground_scrolling_offset_, background_without_ground_h_, &ground_clip);
-	background_texture_->Render(renderer_, ground_scrolling_offset_ + constants::screen_width, background_without_ground_h_, &ground_clip);
+	atlas_->texture_.Render(renderer_, ground_x, background_without_ground_h_, &ground_clip);
+	atlas_->texture_.Render(renderer_, ground_x + constants::screen_width, background_without_ground_h_, &ground_clip);
 
 	player_->Render();
-	score_info_->Render(renderer_, (constants::screen_width / 2) - score_info_->width_ / 2, 0);
 
 	for (auto& obstacle : obstacles_)
 	{
@@ -296,36 +992,266 @@ void Game::Render()
 	{
 		bonus_item->Render();
 	}
+}
+
+void Game::RenderParticles()
+{
+	const std::uint64_t particles_start = SDL_GetPerformanceCounter();
+
+	// With damage tracking the particles are drawn once, clipped to the union of the dirty rects they reach. Spread
+	// made their whole bounds dirty as soon as any of it was, so the union never covers pixels kept from last frame.
+	SDL_Rect clip = { 0, 0, 0, 0 };
+	bool visible = damage_tracker_ == nullptr;
+
+	if (damage_tracker_ != nullptr)
+	{
+		for (const SDL_Rect& dirty_rect : damage_tracker_->DirtyRects())
+		{
+			if (!SDL_HasIntersection(&dirty_rect, &particles_->Bounds()))
+			{
+				continue;
+			}
+
+			if (visible)
+			{
+				SDL_UnionRect(&clip, &dirty_rect, &clip);
+			}
+			else
+			{
+				clip = dirty_rect;
+				visible = true;
+			}
+		}
+	}
+
+	if (visible)
+	{
+		const SDL_Rect* clip_rect = damage_tracker_ != nullptr ? &clip : nullptr;
+
+		if (framebuffer_ != nullptr)
+		{
+			framebuffer_->SetClip(clip_rect);
+			particles_->Render(*framebuffer_);
+			framebuffer_->SetClip(nullptr);
+		}
+		else
+		{
+			SDL_RenderSetClipRect(renderer_, clip_rect);
+			particles_->Render(renderer_);
+			SDL_RenderSetClipRect(renderer_, nullptr);
+		}
+	}
+
+	particle_render_time_ += static_cast<double>(SDL_GetPerformanceCounter() - particles_start) / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+int Game::GroundX() const
+{
+	return static_cast<int>(std::floor(previous_ground_scrolling_offset_.ToFloat() + (ground_scrolling_offset_ - previous_ground_scrolling_offset_).ToFloat() * render_alpha_));
+}
+
+void Game::RenderHud()
+{
+	// Text textures come after the scene so the atlas stays bound for the whole scene.
+	score_info_->Render(renderer_, (constants::screen_width / 2) - score_info_->Width() / 2, 0);
 
 	if (game_over_)
 	{
 		game_over_info_->Render(renderer_, (constants::screen_width / 2) - game_over_info_->width_ / 2, constants::screen_height / 2);
 	}
+}
+
+void Game::TrackScene()
+{
+	const SDL_Rect ground_rect = { GroundX(), background_without_ground_h_, 2 * constants::screen_width, constants::screen_height - background_without_ground_h_ };
+	damage_tracker_->Track(ground_rect, 0);
+
+	player_->TrackDamage(*damage_tracker_);
+
+	for (auto& obstacle : obstacles_)
+	{
+		obstacle->TrackDamage(*damage_tracker_);
+	}
+
+	for (auto& bonus_item : bonus_items_)
+	{
+		bonus_item->TrackDamage(*damage_tracker_);
+	}
+
+	// Live particles move every tick, so their bounds are dirty whenever the simulation advanced.
+	damage_tracker_->Track(particles_->Bounds(), static_cast<std::uint32_t>(tick_count_));
+
+	const SDL_Rect score_rect = { (constants::screen_width / 2) - score_info_->Width() / 2, 0, score_info_->Width(), score_info_->Height() };
+	damage_tracker_->Track(score_rect, static_cast<std::uint32_t>(displayed_score_));
+
+	if (game_over_)
+	{
+		const SDL_Rect game_over_rect = { (constants::screen_width / 2) - game_over_info_->width_ / 2, constants::screen_height / 2, game_over_info_->width_, game_over_info_->height_ };
+		damage_tracker_->Track(game_over_rect, 0);
+	}
+}
+
+void Game::Present()
+{
+	if (framebuffer_ != nullptr)
+	{
+		if (options_.headless)
+		{
+			return;
+		}
+
+		// Only the pixels that changed are uploaded, the texture still holds the rest from earlier frames.
+		if (damage_tracker_ != nullptr)
+		{
+			for (const SDL_Rect& dirty_rect : damage_tracker_->DirtyRects())
+			{
+				SDL_UpdateTexture(framebuffer_texture_, &dirty_rect, framebuffer_->Pixels(dirty_rect.x, dirty_rect.y), framebuffer_->Pitch());
+			}
+		}
+		else
+		{
+			SDL_UpdateTexture(framebuffer_texture_, nullptr, framebuffer_->Pixels(), framebuffer_->Pitch());
+		}
+
+		SDL_RenderCopy(renderer_, framebuffer_texture_, nullptr, nullptr);
+	}
+
+	if (frame_capture_ != nullptr)
+	{
+		if (framebuffer_ != nullptr)
+		{
+			frame_capture_->Capture(framebuffer_->Pixels(), framebuffer_->Pitch());
+		}
+		else
+		{
+			frame_capture_->Capture(renderer_);
+		}
+	}
 
 	SDL_RenderPresent(renderer_);
 }
 
 void Game::Stop()
 {
+	if (!game_over_ && music_ != nullptr)
+	{
+		music_->CrossFade(options_.game_over_music_path.c_str(), 1000);
+	}
+
 	game_over_ = true;
 }
 
 void Game::Reset()
 {
+	++resets_;
+
+	if (music_ != nullptr)
+	{
+		music_->CrossFade(options_.music_path.c_str(), 1000);
+	}
+
 	game_over_ = false;
+	tick_count_ = 0;
 	score_ = 0;
-	scrolling_speed_ = 10;
-	obstacles_.clear();
-	bonus_items_.clear();
+	SetScrollingSpeed(constants::scrolling_speed);
+	particles_->Clear();
 
 	SpawnObjects();
 
+	snapshots_.Clear();
+	SaveSnapshot(snapshots_.Push());
+
 	UpdateScoreText();
 }
 
 void Game::UpdateScoreText()
 {
-	SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
-	const std::string score_text = "Score: " + std::to_string(score_);
-	score_info_->LoadFromText(renderer_, font_, score_text.c_str(), text_color);
-}
\ No newline at end of file
+	if (score_ == displayed_score_)
+	{
+		return;
+	}
+
+	displayed_score_ = score_;
+	score_info_->SetValue(score_);
+}
+
+Fixed Game::ScrollPerTick() const
+{
+	return scroll_per_tick_;
+}
+
+void Game::SetScrollingSpeed(int scrolling_speed)
+{
+	scrolling_speed_ = scrolling_speed;
+	scroll_per_tick_ = Fixed::PerTick(scrolling_speed, tick_rate_);
+}
+
+void Game::SaveSnapshot(Snapshot& snapshot) const
+{
+	snapshot.tick_count = tick_count_;
+	snapshot.score = score_;
+	snapshot.scrolling_speed = scrolling_speed_;
+	snapshot.ground_scrolling_offset = ground_scrolling_offset_;
+	snapshot.game_over = game_over_;
+
+	player_->SaveState(snapshot.player);
+
+	for (int i = 0; i < constants::obstacle_count; ++i)
+	{
+		obstacles_[i]->SaveState(snapshot.obstacles[i]);
+	}
+
+	for (int i = 0; i < constants::bonus_item_count; ++i)
+	{
+		bonus_items_[i]->SaveState(snapshot.bonus_items[i]);
+	}
+}
+
+void Game::LoadSnapshot(const Snapshot& snapshot)
+{
+	tick_count_ = snapshot.tick_count;
+	score_ = snapshot.score;
+	SetScrollingSpeed(snapshot.scrolling_speed);
+	ground_scrolling_offset_ = snapshot.ground_scrolling_offset;
+	previous_ground_scrolling_offset_ = snapshot.ground_scrolling_offset;
+
+	if (game_over_ && !snapshot.game_over && music_ != nullptr)
+	{
+		music_->CrossFade(options_.music_path.c_str(), 1000);
+	}
+
+	game_over_ = snapshot.game_over;
+
+	player_->LoadState(snapshot.player);
+
+	for (int i = 0; i < constants::obstacle_count; ++i)
+	{
+		obstacles_[i]->LoadState(snapshot.obstacles[i]);
+	}
+
+	for (int i = 0; i < constants::bonus_item_count; ++i)
+	{
+		bonus_items_[i]->LoadState(snapshot.bonus_items[i]);
+	}
+
+	UpdateScoreText();
+}
+
+void Game::Rewind(int ticks)
+{
+	const Snapshot* snapshot = snapshots_.Rewind(ticks);
+
+	if (snapshot == nullptr)
+	{
+		return;
+	}
+
+	const std::uint64_t restore_start = SDL_GetPerformanceCounter();
+	LoadSnapshot(*snapshot);
+	const double restore_time = static_cast<double>(SDL_GetPerformanceCounter() - restore_start) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+	if (options_.stats)
+	{
+		printf("Rewound to tick %llu in %.0f ns\n", static_cast<unsigned long long>(snapshot->tick_count), 1e9 * restore_time);
+	}
+}
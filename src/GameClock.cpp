@@ -0,0 +1,112 @@
+#include "GameClock.hpp"
+
+GameClock::GameClock(long double tick_length) : 
+	tick_length_(tick_length), 
+	accumulator_(0.0), 
+	time_scale_(1.0), 
+	ticks_per_frame_(0), 
+	max_frame_time_(0.0), 
+	dropped_time_(0.0), 
+	uncapped_(false), 
+	paused_(false), 
+	pending_steps_(0)
+{
+}
+
+GameClock::~GameClock()
+{
+}
+
+int GameClock::Advance(long double elapsed)
+{
+	if (paused_)
+	{
+		const int steps = pending_steps_;
+		pending_steps_ = 0;
+		return steps;
+	}
+
+	if (ticks_per_frame_ > 0)
+	{
+		return ticks_per_frame_;
+	}
+
+	// After a stall the ticks to catch up would take long enough to cause the next stall, so wall time beyond one
+	// frame's worth is dropped and the game slows down instead. This is applied before scaling, so fast-forward is
+	// only limited by how fast the ticks run and only real stalls drop ticks.
+	if (max_frame_time_ > 0.0 && elapsed > max_frame_time_)
+	{
+		dropped_time_ += (elapsed - max_frame_time_) * time_scale_;
+		elapsed = max_frame_time_;
+	}
+
+	accumulator_ += elapsed * time_scale_;
+
+	int ticks = 0;
+
+	while (accumulator_ >= tick_length_)
+	{
+		accumulator_ -= tick_length_;
+		++ticks;
+	}
+
+	return ticks;
+}
+
+void GameClock::SetTimeScale(double time_scale)
+{
+	time_scale_ = time_scale;
+}
+
+void GameClock::SetTicksPerFrame(int ticks_per_frame)
+{
+	ticks_per_frame_ = ticks_per_frame;
+}
+
+void GameClock::SetMaxFrameTime(long double max_frame_time)
+{
+	max_frame_time_ = max_frame_time;
+}
+
+std::uint64_t GameClock::DroppedTicks() const
+{
+	return static_cast<std::uint64_t>(dropped_time_ / tick_length_);
+}
+
+void GameClock::SetUncapped(bool uncapped)
+{
+	uncapped_ = uncapped;
+}
+
+bool GameClock::Uncapped() const
+{
+	return uncapped_ && !paused_;
+}
+
+float GameClock::Alpha() const
+{
+	// Without a wall clock driving the ticks there is no leftover time, the latest tick is shown as is.
+	if (paused_ || uncapped_ || ticks_per_frame_ > 0)
+	{
+		return 1.0f;
+	}
+
+	return static_cast<float>(accumulator_ / tick_length_);
+}
+
+void GameClock::TogglePause()
+{
+	paused_ = !paused_;
+	pending_steps_ = 0;
+
+	// Wall time spent paused must not turn into a burst of ticks on resume.
+	accumulator_ = 0.0;
+}
+
+void GameClock::Step()
+{
+	if (paused_)
+	{
+		++pending_steps_;
+	}
+}
@@ -0,0 +1,185 @@
+#include "MetricsExport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MetricsExport::MetricsExport(const std::string& name) : 
+	name_(name), 
+	shared_(nullptr), 
+	frame_(0), 
+	frame_times_(), 
+	frame_ticks_(), 
+	next_(0), 
+	filled_(0)
+{
+}
+
+MetricsExport::~MetricsExport()
+{
+	if (shared_ != nullptr)
+	{
+		munmap(shared_, sizeof(SharedMetrics));
+		shared_ = nullptr;
+
+		// A stopped game leaves nothing behind for readers to mistake for live data.
+		shm_unlink(name_.c_str());
+	}
+}
+
+bool MetricsExport::Open()
+{
+	const int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+
+	if (fd == -1)
+	{
+		printf("Unable to create shared memory %s!\n", name_.c_str());
+		return false;
+	}
+
+	if (ftruncate(fd, sizeof(SharedMetrics)) == -1)
+	{
+		printf("Unable to size shared memory %s!\n", name_.c_str());
+		close(fd);
+		return false;
+	}
+
+	void* memory = mmap(nullptr, sizeof(SharedMetrics), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (memory == MAP_FAILED)
+	{
+		printf("Unable to map shared memory %s!\n", name_.c_str());
+		return false;
+	}
+
+	std::memset(memory, 0, sizeof(SharedMetrics));
+
+	shared_ = static_cast<SharedMetrics*>(memory);
+	shared_->version.store(SharedMetrics::version_value, std::memory_order_relaxed);
+	shared_->magic.store(SharedMetrics::magic_value, std::memory_order_release);
+
+	return true;
+}
+
+void MetricsExport::Publish(MetricsSample& sample, double frame_time, int ticks)
+{
+	frame_times_[next_] = frame_time;
+	frame_ticks_[next_] = ticks;
+	next_ = (next_ + 1) % window;
+	filled_ = std::min(filled_ + 1, window);
+
+	double total_time = 0.0;
+	int total_ticks = 0;
+	double sorted[window];
+
+	for (std::size_t i = 0; i < filled_; ++i)
+	{
+		total_time += frame_times_[i];
+		total_ticks += frame_ticks_[i];
+		sorted[i] = frame_times_[i];
+	}
+
+	// Percentiles over the last couple of seconds, partial selection is enough for three of them.
+	const auto percentile = [&sorted, this](double p)
+	{
+		double* nth = sorted + static_cast<std::size_t>(p * (filled_ - 1));
+		std::nth_element(sorted, nth, sorted + filled_);
+		return 1000.0 * *nth;
+	};
+
+	sample.frame = frame_++;
+	sample.fps = total_time > 0.0 ? filled_ / total_time : 0.0;
+	sample.tick_rate = total_time > 0.0 ? total_ticks / total_time : 0.0;
+	sample.frame_ms_p50 = percentile(0.50);
+	sample.frame_ms_p95 = percentile(0.95);
+	sample.frame_ms_p99 = percentile(0.99);
+
+	std::uint64_t words[SharedMetrics::word_count];
+	std::memcpy(words, &sample, sizeof(sample));
+
+	const std::uint64_t sequence = shared_->sequence.load(std::memory_order_relaxed);
+	shared_->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (std::size_t i = 0; i < SharedMetrics::word_count; ++i)
+	{
+		shared_->words[i].store(words[i], std::memory_order_relaxed);
+	}
+
+	shared_->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SharedMetrics* MetricsExport::Attach(const std::string& name)
+{
+	const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+
+	if (fd == -1)
+	{
+		return nullptr;
+	}
+
+	// A segment still being sized by the game, or left by another program, is shorter than the layout, and touching
+	// a mapped page past its end raises SIGBUS.
+	struct stat status;
+
+	if (fstat(fd, &status) == -1 || status.st_size < static_cast<off_t>(sizeof(SharedMetrics)))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void* memory = mmap(nullptr, sizeof(SharedMetrics), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (memory == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	SharedMetrics* shared = static_cast<SharedMetrics*>(memory);
+
+	if (shared->magic.load(std::memory_order_acquire) != SharedMetrics::magic_value || shared->version.load(std::memory_order_relaxed) != SharedMetrics::version_value)
+	{
+		munmap(memory, sizeof(SharedMetrics));
+		return nullptr;
+	}
+
+	return shared;
+}
+
+bool MetricsExport::Read(const SharedMetrics& shared, MetricsSample& sample)
+{
+	std::uint64_t words[SharedMetrics::word_count];
+
+	// A torn read is detected by the sequence changing or being odd, the reader then simply tries again.
+	for (int attempt = 0; attempt < 100; ++attempt)
+	{
+		const std::uint64_t before = shared.sequence.load(std::memory_order_acquire);
+
+		if (before % 2 != 0)
+		{
+			continue;
+		}
+
+		for (std::size_t i = 0; i < SharedMetrics::word_count; ++i)
+		{
+			words[i] = shared.words[i].load(std::memory_order_relaxed);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (shared.sequence.load(std::memory_order_relaxed) == before)
+		{
+			std::memcpy(&sample, words, sizeof(sample));
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,75 @@
+#include "MetricsLog.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+MetricsLog::MetricsLog(const std::string& path) : path_(path), file_(nullptr), elapsed_(0.0)
+{
+}
+
+MetricsLog::~MetricsLog()
+{
+	if (file_ != nullptr)
+	{
+		std::fclose(file_);
+		file_ = nullptr;
+	}
+}
+
+bool MetricsLog::Open()
+{
+	file_ = std::fopen(path_.c_str(), "w");
+
+	if (file_ == nullptr)
+	{
+		printf("Unable to open metrics file %s!\n", path_.c_str());
+		return false;
+	}
+
+	std::fprintf(file_, "seconds,frames,ticks,frame_ms_avg,frame_ms_max,score,scrolling_speed,resets,rss_kb,allocs_per_frame,alloc_bytes_per_frame\n");
+	std::fflush(file_);
+
+	return true;
+}
+
+void MetricsLog::Write(const FrameMetrics& metrics, int score, int scrolling_speed, int resets)
+{
+	elapsed_ += 1.0;
+
+	const double frame_ms_avg = metrics.frames > 0 ? 1000.0 * metrics.frame_time_total / metrics.frames : 0.0;
+
+	const double allocs_per_frame = metrics.frames > 0 ? static_cast<double>(metrics.allocations) / metrics.frames : 0.0;
+	const double alloc_bytes_per_frame = metrics.frames > 0 ? static_cast<double>(metrics.allocated_bytes) / metrics.frames : 0.0;
+
+	std::fprintf(file_, "%.0f,%d,%d,%.3f,%.3f,%d,%d,%d,%ld,%.1f,%.0f\n", elapsed_, metrics.frames, metrics.ticks, frame_ms_avg, 1000.0 * metrics.frame_time_max, score, scrolling_speed, resets, ResidentSetKilobytes(), allocs_per_frame, alloc_bytes_per_frame);
+
+	// Flushed every line so a soak run that gets killed still leaves a complete log behind.
+	std::fflush(file_);
+}
+
+long MetricsLog::ResidentSetKilobytes()
+{
+#ifdef __linux__
+	std::FILE* statm = std::fopen("/proc/self/statm", "r");
+
+	if (statm == nullptr)
+	{
+		return 0;
+	}
+
+	long size = 0;
+	long resident = 0;
+
+	if (std::fscanf(statm, "%ld %ld", &size, &resident) != 2)
+	{
+		resident = 0;
+	}
+
+	std::fclose(statm);
+
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,400 @@
+#include "Music.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <time.h>
+
+Music::Deck::Deck() : file_open(false), channels(0), ring(1 << 16), state(IDLE), gain(0.0f)
+{
+}
+
+Music::Music() : 
+	active_deck_(-1), 
+	fade_frames_(1), 
+	underruns_(0), 
+	mix_buffer_(1 << 14), 
+	stopping_(false), 
+	request_pending_(false), 
+	request_path_(""), 
+	request_fade_ms_(0), 
+	frequency_(0), 
+	channels_(0), 
+	decode_cpu_seconds_(0.0), 
+	opened_(false)
+{
+}
+
+Music::~Music()
+{
+	Close();
+}
+
+bool Music::Open()
+{
+	Uint16 format = 0;
+
+	if (Mix_QuerySpec(&frequency_, &format, &channels_) == 0)
+	{
+		printf("Unable to query audio format! SDL_mixer Error: %s\n", Mix_GetError());
+		return false;
+	}
+
+	if (format != AUDIO_S16SYS || channels_ < 1 || channels_ > 2)
+	{
+		printf("%s\n", "Music needs 16-bit mono or stereo output!");
+		return false;
+	}
+
+	decoder_ = std::thread(&Music::Decode, this);
+	Mix_HookMusic(&Music::Mix, this);
+	opened_ = true;
+
+	return true;
+}
+
+void Music::CrossFade(const char* path, int fade_ms)
+{
+	if (!opened_)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		request_path_ = path != nullptr ? path : "";
+		request_fade_ms_ = fade_ms;
+		request_pending_ = true;
+	}
+
+	wake_.notify_one();
+}
+
+void Music::Close()
+{
+	if (!opened_)
+	{
+		return;
+	}
+
+	// Returns only once the audio callback is no longer running.
+	Mix_HookMusic(nullptr, nullptr);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	wake_.notify_one();
+	decoder_.join();
+
+	for (Deck& deck : decks_)
+	{
+		if (deck.file_open)
+		{
+			ov_clear(&deck.file);
+			deck.file_open = false;
+		}
+	}
+
+	printf("Music: %llu underruns, decode thread CPU %.1f ms\n", static_cast<unsigned long long>(Underruns()), 1000.0 * DecodeCpuSeconds());
+
+	opened_ = false;
+}
+
+std::uint64_t Music::Underruns() const
+{
+	return underruns_.load(std::memory_order_relaxed);
+}
+
+double Music::DecodeCpuSeconds() const
+{
+	return decode_cpu_seconds_.load(std::memory_order_relaxed);
+}
+
+void Music::Decode()
+{
+	bool deferred = false;
+	std::string path;
+
+	for (;;)
+	{
+		bool has_request = false;
+		int fade_ms = 0;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			// A deferred request waits for the next pass instead of spinning until the callback frees a deck.
+			wake_.wait_for(lock, std::chrono::milliseconds(5), [this, deferred]()
+			{
+				return stopping_ || (request_pending_ && !deferred);
+			});
+
+			if (stopping_)
+			{
+				break;
+			}
+
+			has_request = request_pending_;
+			path = request_path_;
+			fade_ms = request_fade_ms_;
+		}
+
+		// A request that finds no free deck stays pending and is retried on the next pass, after the active deck
+		// has been topped up, unless a newer request replaces it first.
+		deferred = has_request && !StartTrack(path, fade_ms);
+
+		if (has_request && !deferred)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (request_path_ == path && request_fade_ms_ == fade_ms)
+			{
+				request_pending_ = false;
+			}
+		}
+
+		for (Deck& deck : decks_)
+		{
+			Fill(deck);
+		}
+
+		decode_cpu_seconds_.store(ThreadCpuSeconds(), std::memory_order_relaxed);
+	}
+}
+
+bool Music::StartTrack(const std::string& path, int fade_ms)
+{
+	fade_frames_.store(std::max(1, static_cast<int>(static_cast<long>(fade_ms) * frequency_ / 1000)));
+
+	if (path.empty())
+	{
+		active_deck_.store(-1, std::memory_order_release);
+		return true;
+	}
+
+	const int active = active_deck_.load(std::memory_order_acquire);
+	int next = -1;
+
+	for (int d = 0; d < 2; ++d)
+	{
+		if (d != active && decks_[d].state.load(std::memory_order_acquire) == IDLE)
+		{
+			next = d;
+			break;
+		}
+	}
+
+	if (next < 0)
+	{
+		// Every deck that could take the track is still fading out. Cutting it is quicker than waiting for the fade,
+		// and the callback lets go of it within one buffer.
+		for (int d = 0; d < 2; ++d)
+		{
+			int playing = PLAYING;
+
+			if (d != active)
+			{
+				decks_[d].state.compare_exchange_strong(playing, STOPPING, std::memory_order_acq_rel);
+			}
+		}
+
+		return false;
+	}
+
+	Deck& deck = decks_[next];
+
+	if (!Load(deck, path))
+	{
+		active_deck_.store(-1, std::memory_order_release);
+		return true;
+	}
+
+	deck.ring.Reset();
+	Fill(deck);
+
+	deck.state.store(PLAYING, std::memory_order_release);
+	active_deck_.store(next, std::memory_order_release);
+
+	return true;
+}
+
+bool Music::Load(Deck& deck, const std::string& path)
+{
+	if (deck.file_open)
+	{
+		ov_clear(&deck.file);
+		deck.file_open = false;
+	}
+
+	// A missing track is not an error, it fades to silence.
+	std::error_code error;
+
+	if (!std::filesystem::exists(path, error))
+	{
+		return false;
+	}
+
+	if (ov_fopen(path.c_str(), &deck.file) != 0)
+	{
+		// Broken tracks are reported once, not on every reset.
+		if (path != failed_path_)
+		{
+			printf("Unable to open music %s!\n", path.c_str());
+			failed_path_ = path;
+		}
+
+		return false;
+	}
+
+	const vorbis_info* info = ov_info(&deck.file, -1);
+
+	if (info->rate != frequency_)
+	{
+		printf("Music %s is %ld Hz but the output is %d Hz, it will play at the wrong pitch!\n", path.c_str(), info->rate, frequency_);
+	}
+
+	deck.channels = info->channels;
+	deck.file_open = true;
+
+	return true;
+}
+
+void Music::Fill(Deck& deck)
+{
+	if (!deck.file_open)
+	{
+		return;
+	}
+
+	constexpr int decode_bytes = 4096;
+	constexpr std::size_t max_output_samples = decode_bytes;
+
+	char decoded[decode_bytes];
+	std::int16_t output[max_output_samples];
+
+	int empty_reads = 0;
+
+	// Decoding stops as soon as the next chunk might not fit, so the ring never needs more memory.
+	while (deck.ring.Free() >= max_output_samples && empty_reads < 2)
+	{
+		int bitstream = 0;
+		const long bytes = ov_read(&deck.file, decoded, decode_bytes, SDL_BYTEORDER == SDL_BIG_ENDIAN, 2, 1, &bitstream);
+
+		if (bytes == 0)
+		{
+			// End of the track, music loops.
+			ov_pcm_seek(&deck.file, 0);
+			++empty_reads;
+			continue;
+		}
+
+		if (bytes < 0)
+		{
+			++empty_reads;
+			continue;
+		}
+
+		empty_reads = 0;
+
+		const std::int16_t* samples = reinterpret_cast<const std::int16_t*>(decoded);
+		const std::size_t frames = static_cast<std::size_t>(bytes) / sizeof(std::int16_t) / deck.channels;
+
+		for (std::size_t frame = 0; frame < frames; ++frame)
+		{
+			for (int channel = 0; channel < channels_; ++channel)
+			{
+				output[frame * channels_ + channel] = samples[frame * deck.channels + std::min(channel, deck.channels - 1)];
+			}
+		}
+
+		deck.ring.Write(output, frames * channels_);
+	}
+}
+
+void Music::Mix(void* music, Uint8* stream, int length)
+{
+	Music* self = static_cast<Music*>(music);
+	std::int16_t* out = reinterpret_cast<std::int16_t*>(stream);
+	const std::size_t count = static_cast<std::size_t>(length) / sizeof(std::int16_t);
+	const std::size_t channels = static_cast<std::size_t>(self->channels_);
+
+	std::memset(stream, 0, length);
+
+	const int active = self->active_deck_.load(std::memory_order_acquire);
+	const float step = 1.0f / self->fade_frames_.load(std::memory_order_relaxed);
+
+	for (int d = 0; d < 2; ++d)
+	{
+		Deck& deck = self->decks_[d];
+		const int state = deck.state.load(std::memory_order_acquire);
+
+		if (state == STOPPING)
+		{
+			deck.gain = 0.0f;
+			deck.state.store(IDLE, std::memory_order_release);
+			continue;
+		}
+
+		if (state != PLAYING)
+		{
+			continue;
+		}
+
+		const float target = d == active ? 1.0f : 0.0f;
+		bool starved = false;
+
+		for (std::size_t done = 0; done < count;)
+		{
+			const std::size_t n = std::min(count - done, self->mix_buffer_.size());
+			const std::size_t got = deck.ring.Read(self->mix_buffer_.data(), n);
+
+			starved = starved || got < n;
+
+			// The gain keeps ramping over missing samples, so a starved deck still fades out.
+			for (std::size_t i = 0; i < n; i += channels)
+			{
+				deck.gain = deck.gain < target ? std::min(target, deck.gain + step) : std::max(target, deck.gain - step);
+
+				for (std::size_t c = 0; c < channels && i + c < got; ++c)
+				{
+					const int mixed = out[done + i + c] + static_cast<int>(self->mix_buffer_[i + c] * deck.gain);
+					out[done + i + c] = static_cast<std::int16_t>(std::clamp(mixed, -32768, 32767));
+				}
+			}
+
+			done += n;
+		}
+
+		if (starved && d == active)
+		{
+			++self->underruns_;
+		}
+
+		if (target == 0.0f && deck.gain <= 0.0f)
+		{
+			// A cut that arrived while the deck was being mixed is left for the next callback.
+			int playing = PLAYING;
+			deck.state.compare_exchange_strong(playing, IDLE, std::memory_order_acq_rel);
+		}
+	}
+}
+
+double Music::ThreadCpuSeconds()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+	timespec now;
+
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0)
+	{
+		return now.tv_sec + now.tv_nsec / 1e9;
+	}
+#endif
+
+	return 0.0;
+}
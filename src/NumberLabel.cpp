@@ -0,0 +1,92 @@
+#include "NumberLabel.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+NumberLabel::NumberLabel() : value_length_(0), value_width_(0)
+{
+	std::fill(digit_x_, digit_x_ + 11, 0);
+}
+
+NumberLabel::~NumberLabel()
+{
+}
+
+bool NumberLabel::Load(SDL_Renderer* renderer, TTF_Font* font, const char* label, const SDL_Color& color, Framebuffer* framebuffer)
+{
+	constexpr const char* digits = "0123456789";
+
+	label_.framebuffer_ = framebuffer;
+	digits_.framebuffer_ = framebuffer;
+
+	if (!label_.LoadFromText(renderer, font, label, color) || !digits_.LoadFromText(renderer, font, digits, color))
+	{
+		return false;
+	}
+
+	// Each digit ends where the strip up to and including it ends.
+	char prefix[11] = {};
+
+	for (int i = 1; i <= 10; ++i)
+	{
+		std::memcpy(prefix, digits, i);
+
+		if (TTF_SizeText(font, prefix, &digit_x_[i], nullptr) != 0)
+		{
+			printf("Unable to measure digits! SDL_ttf Error: %s\n", TTF_GetError());
+			return false;
+		}
+	}
+
+	SetValue(0);
+
+	return true;
+}
+
+void NumberLabel::SetValue(int value)
+{
+	unsigned int remaining = static_cast<unsigned int>(std::max(0, value));
+
+	value_length_ = 0;
+	value_width_ = 0;
+
+	do
+	{
+		value_digits_[value_length_++] = static_cast<char>(remaining % 10);
+		remaining /= 10;
+	}
+	while (remaining > 0);
+
+	std::reverse(value_digits_, value_digits_ + value_length_);
+
+	for (int i = 0; i < value_length_; ++i)
+	{
+		const int digit = value_digits_[i];
+		value_width_ += digit_x_[digit + 1] - digit_x_[digit];
+	}
+}
+
+int NumberLabel::Width() const
+{
+	return label_.width_ + value_width_;
+}
+
+int NumberLabel::Height() const
+{
+	return std::max(label_.height_, digits_.height_);
+}
+
+void NumberLabel::Render(SDL_Renderer* renderer, int x, int y)
+{
+	label_.Render(renderer, x, y);
+	x += label_.width_;
+
+	for (int i = 0; i < value_length_; ++i)
+	{
+		const int digit = value_digits_[i];
+		SDL_Rect clip = { digit_x_[digit], 0, digit_x_[digit + 1] - digit_x_[digit], digits_.height_ };
+
+		digits_.Render(renderer, x, y, &clip);
+		x += clip.w;
+	}
+}
@@ -5,17 +5,24 @@
 #include <cassert>
 #include <iostream>
 
-Obstacle::Obstacle(Game* game, Texture* sprites_texture, ObstacleType type, int x, float scale) : Entity(game, sprites_texture), type_(type)
+Obstacle::Obstacle(Game* game, TextureAtlas* atlas, ObstacleType type, int x, float scale, const RandomStream& random) : Entity(game, atlas, random), type_(type)
 {
 	scale_ = scale;
 	SetType(type);
-	bounding_box_.x = x;
+	SetX(x);
 }
 
 Obstacle::~Obstacle()
 {
 }
 
+void Obstacle::Reset(ObstacleType type, int x, const RandomStream& random)
+{
+	random_ = random;
+	SetType(type);
+	SetX(x);
+}
+
 void Obstacle::HandleEvent(SDL_Event* e)
 {
 	(void) e;
@@ -23,33 +30,40 @@ void Obstacle::HandleEvent(SDL_Event* e)
 
 void Obstacle::Tick()
 {
-	bounding_box_.x -= game_->scrolling_speed_;
+	Scroll();
 
 	if (bounding_box_.x + bounding_box_.w < 0)
 	{
 		Respawn();
 	}
+
+	if (type_ == ObstacleType::FIRE && bounding_box_.x < constants::screen_width)
+	{
+		game_->particles_->Emit(ParticleEmitter::EMBER, bounding_box_.x + bounding_box_.w / 2.0f, bounding_box_.y + bounding_box_.h / 4.0f);
+	}
 }
 
 void Obstacle::Render()
 {
+	const int x = RenderX();
+
 	switch (type_)
 	{
 	case ObstacleType::SINGLE_BOX:
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y, &sprites_clip_, scale_);
 		break;
 	case ObstacleType::DOUBLE_BOX:
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, &sprites_clip_, scale_);
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
 		break;
 	case ObstacleType::QUAD_BOX:
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x + (sprites_clip_.w * scale_), bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x + (sprites_clip_.w * scale_), bounding_box_.y, &sprites_clip_, scale_);
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x + (sprites_clip_.w * scale_), bounding_box_.y + (sprites_clip_.h * scale_), &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x + (sprites_clip_.w * scale_), bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y, &sprites_clip_, scale_);
 		break;
 	case ObstacleType::FIRE:
-		sprites_texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, &sprites_clip_, scale_);
+		atlas_->texture_.Render(game_->renderer_, x, bounding_box_.y, &sprites_clip_, scale_);
 		break;
 	}
 
@@ -60,16 +74,30 @@ void Obstacle::Render()
 void Obstacle::Respawn()
 {
 	constexpr int distances[4] = { 400, 600, 800, 1000 };
-	SetType(static_cast<ObstacleType>(game_->random_index_(game_->mt_)));
-	
-	auto max_it = std::max_element(game_->obstacles_.begin(), game_->obstacles_.end(), [](const std::unique_ptr<Obstacle>& o1, const std::unique_ptr<Obstacle>& o2)
-	{
-		return o1->bounding_box_.x < o2->bounding_box_.x;
-	});
+	SetType(static_cast<ObstacleType>(random_.Below(obstacle_type_count)));
+	SetX(game_->rightmost_obstacle_x_ + distances[random_.Below(4)]);
+}
+
+void Obstacle::SaveState(EntityState& state) const
+{
+	state.bounding_box = bounding_box_;
+	state.x = x_;
+	state.random = random_;
+	state.type = static_cast<int>(type_);
+}
 
-	assert(max_it != game_->obstacles_.end());
+void Obstacle::LoadState(const EntityState& state)
+{
+	SetType(static_cast<ObstacleType>(state.type));
+	bounding_box_ = state.bounding_box;
+	x_ = state.x;
+	previous_x_ = state.x;
+	random_ = state.random;
+}
 
-	bounding_box_.x = (*max_it)->bounding_box_.x + distances[game_->random_index_(game_->mt_)];
+const CollisionMask& Obstacle::Mask() const
+{
+	return game_->obstacle_masks_[static_cast<int>(type_)];
 }
 
 void Obstacle::SetType(ObstacleType type)
@@ -79,18 +107,7 @@ void Obstacle::SetType(ObstacleType type)
 	const int sprite_side_size = 32;
 	const int scaled_sprite_side_size = sprite_side_size * scale_;
 
-	if (type == ObstacleType::FIRE)
-	{
-		sprites_clip_.x = 0;
-	}
-	else if (type == ObstacleType::SINGLE_BOX || type == ObstacleType::DOUBLE_BOX || type == ObstacleType::QUAD_BOX)
-	{
-		sprites_clip_.x = sprite_side_size;
-	}
-
-	sprites_clip_.y = 0;
-	sprites_clip_.w = sprite_side_size;
-	sprites_clip_.h = sprite_side_size;
+	sprites_clip_ = SpriteClip(*atlas_, type);
 
 	switch (type)
 	{
@@ -113,4 +130,43 @@ void Obstacle::SetType(ObstacleType type)
 	}
 
 	bounding_box_.y = game_->background_without_ground_h_ - bounding_box_.h;
+
+}
+
+SDL_Rect Obstacle::SpriteClip(const TextureAtlas& atlas, ObstacleType type)
+{
+	const int sprite_side_size = 32;
+
+	if (type == ObstacleType::FIRE)
+	{
+		return atlas.Clip(AtlasRegion::OBJECTS, 0, 0, sprite_side_size, sprite_side_size);
+	}
+
+	return atlas.Clip(AtlasRegion::OBJECTS, sprite_side_size, 0, sprite_side_size, sprite_side_size);
+}
+
+CollisionMask Obstacle::BuildMask(const TextureAtlas& atlas, ObstacleType type, int scale)
+{
+	// Same layout as Render: stacked boxes are the single box mask repeated.
+	const CollisionMask sprite = atlas.Mask(SpriteClip(atlas, type), scale);
+	const int w = sprite.Width();
+	const int h = sprite.Height();
+	const bool two_rows = type == ObstacleType::DOUBLE_BOX || type == ObstacleType::QUAD_BOX;
+	const bool two_columns = type == ObstacleType::QUAD_BOX;
+
+	CollisionMask mask(two_columns ? w * 2 : w, two_rows ? h * 2 : h);
+	mask.Add(sprite, 0, 0);
+
+	if (two_rows)
+	{
+		mask.Add(sprite, 0, h);
+	}
+
+	if (two_columns)
+	{
+		mask.Add(sprite, w, 0);
+		mask.Add(sprite, w, h);
+	}
+
+	return mask;
 }
@@ -0,0 +1,204 @@
+#include "Options.hpp"
+#include "Constants.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+static void PrintUsage(const char* program)
+{
+	printf("Usage: %s [options]\n", program);
+	printf("  --software          use SDL's software renderer\n");
+	printf("  --damage-tracking   redraw only regions that changed since the last frame\n");
+	printf("  --stats             print frame statistics once per second\n");
+	printf("  --low-res           draw the scene at native pixel art resolution and upscale it once\n");
+	printf("  --cpu-raster        composite the game on the CPU and present it as a single streaming texture\n");
+	printf("  --headless          with --cpu-raster, render every frame but never present it\n");
+	printf("  --no-music          do not stream background music\n");
+	printf("  --music FILE        stream FILE (OGG Vorbis) during play instead of res/sfx/music.ogg\n");
+	printf("  --game-over-music FILE cross-fade to FILE on game over instead of res/sfx/game_over.ogg\n");
+	printf("  --particle-stress N keep N particles alive to measure particle update and draw cost\n");
+	printf("  --capture-png DIR   save every presented frame as DIR/frame_NNNNNN.png\n");
+	printf("  --capture-raw FILE  append every presented frame to FILE as raw BGRA video\n");
+	printf("  --autopilot         let the game jump over obstacles by itself\n");
+	printf("  --auto-reset        with the autopilot, start a new game right after game over\n");
+	printf("  --metrics FILE      write per-second frame, score and memory metrics to FILE as CSV\n");
+	printf("  --seed N            generate the same worlds every run, from seed N\n");
+	printf("  --tick-rate N       simulate N ticks per second (30 to 1000, default 60), rendering interpolates between ticks\n");
+	printf("  --metrics-shm NAME  publish live metrics every frame in the POSIX shared memory object NAME\n");
+	printf("  --time-scale X      run the simulation X times as fast as real time (e.g. 0.25 or 4)\n");
+	printf("  --ticks-per-frame N run exactly N ticks per rendered frame\n");
+	printf("  --uncapped          run as many ticks as fit into each 60 Hz frame\n");
+	printf("  --checksum-log FILE write a checksum of the simulation state after every tick to FILE\n");
+	printf("  --exit-after-ticks N stop after N ticks and print the checksum of the final state\n");
+	printf("  --alloc-stats       count heap allocations and SDL surfaces and textures per frame and loop phase\n");
+	printf("  --alloc-budget N    with --alloc-stats, fail once any frame after warmup makes more than N allocations\n");
+}
+
+bool ParseOptions(int argc, char* argv[], Options& options)
+{
+	bool music_given = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		if (std::strcmp(arg, "--software") == 0)
+		{
+			options.software_renderer = true;
+		}
+		else if (std::strcmp(arg, "--damage-tracking") == 0)
+		{
+			options.damage_tracking = true;
+		}
+		else if (std::strcmp(arg, "--stats") == 0)
+		{
+			options.stats = true;
+		}
+		else if (std::strcmp(arg, "--low-res") == 0)
+		{
+			options.low_res = true;
+		}
+		else if (std::strcmp(arg, "--cpu-raster") == 0)
+		{
+			options.cpu_raster = true;
+		}
+		else if (std::strcmp(arg, "--headless") == 0)
+		{
+			options.cpu_raster = true;
+			options.headless = true;
+		}
+		else if (std::strcmp(arg, "--no-music") == 0)
+		{
+			options.no_music = true;
+		}
+		else if (std::strcmp(arg, "--music") == 0 && i + 1 < argc)
+		{
+			options.music_path = argv[++i];
+			music_given = true;
+		}
+		else if (std::strcmp(arg, "--game-over-music") == 0 && i + 1 < argc)
+		{
+			options.game_over_music_path = argv[++i];
+		}
+		else if (std::strcmp(arg, "--particle-stress") == 0 && i + 1 < argc)
+		{
+			options.particle_stress = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(arg, "--capture-png") == 0 && i + 1 < argc)
+		{
+			options.capture_png_dir = argv[++i];
+		}
+		else if (std::strcmp(arg, "--capture-raw") == 0 && i + 1 < argc)
+		{
+			options.capture_raw_path = argv[++i];
+		}
+		else if (std::strcmp(arg, "--autopilot") == 0)
+		{
+			options.autopilot = true;
+		}
+		else if (std::strcmp(arg, "--auto-reset") == 0)
+		{
+			options.autopilot = true;
+			options.auto_reset = true;
+		}
+		else if (std::strcmp(arg, "--metrics") == 0 && i + 1 < argc)
+		{
+			options.metrics_path = argv[++i];
+		}
+		else if (std::strcmp(arg, "--metrics-shm") == 0 && i + 1 < argc)
+		{
+			options.metrics_shm_name = argv[++i];
+		}
+		else if (std::strcmp(arg, "--seed") == 0 && i + 1 < argc)
+		{
+			options.seed = std::strtoull(argv[++i], nullptr, 10);
+			options.fixed_seed = true;
+		}
+		else if (std::strcmp(arg, "--tick-rate") == 0 && i + 1 < argc)
+		{
+			options.tick_rate = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(arg, "--time-scale") == 0 && i + 1 < argc)
+		{
+			options.time_scale = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(arg, "--ticks-per-frame") == 0 && i + 1 < argc)
+		{
+			options.ticks_per_frame = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(arg, "--uncapped") == 0)
+		{
+			options.uncapped = true;
+		}
+		else if (std::strcmp(arg, "--checksum-log") == 0 && i + 1 < argc)
+		{
+			options.checksum_log_path = argv[++i];
+		}
+		else if (std::strcmp(arg, "--exit-after-ticks") == 0 && i + 1 < argc)
+		{
+			options.exit_after_ticks = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(arg, "--alloc-stats") == 0)
+		{
+			options.alloc_stats = true;
+		}
+		else if (std::strcmp(arg, "--alloc-budget") == 0 && i + 1 < argc)
+		{
+			options.alloc_stats = true;
+			options.alloc_budget = std::atoi(argv[++i]);
+		}
+		else
+		{
+			printf("Unknown option: %s\n", arg);
+			PrintUsage(argv[0]);
+			return false;
+		}
+	}
+
+	if (!options.fixed_seed)
+	{
+		options.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+	}
+
+	if (options.tick_rate < constants::min_tick_rate || options.tick_rate > constants::max_tick_rate)
+	{
+		printf("Tick rate must be between %d and %d!\n", constants::min_tick_rate, constants::max_tick_rate);
+		return false;
+	}
+
+	if (options.time_scale <= 0.0 || options.ticks_per_frame < 0)
+	{
+		printf("%s\n", "Time scale must be positive and ticks per frame must not be negative!");
+		return false;
+	}
+
+	// The default track is optional, one asked for is not.
+	if (music_given && !std::filesystem::exists(options.music_path))
+	{
+		printf("Music file %s does not exist!\n", options.music_path.c_str());
+		return false;
+	}
+
+	if (options.cpu_raster && options.low_res)
+	{
+		printf("%s\n", "The CPU rasterizer always draws at full resolution and cannot be combined with --low-res!");
+		return false;
+	}
+
+	if (!options.capture_png_dir.empty() && !options.capture_raw_path.empty())
+	{
+		printf("%s\n", "Only one of --capture-png and --capture-raw can be used at a time!");
+		return false;
+	}
+
+	if (options.headless && (!options.capture_png_dir.empty() || !options.capture_raw_path.empty()))
+	{
+		printf("%s\n", "Headless runs never present a frame, so there is nothing to capture!");
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,238 @@
+#include "ParticleSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Emitters are plain data in pixels and seconds, clips are relative to the objects sheet.
+static constexpr EmitterDef emitter_defs[static_cast<int>(ParticleEmitter::COUNT)] = 
+{
+	// DUST: kicked up sideways and slightly upwards when the player lands.
+	{ 12, { 40, 8, 2, 2 }, 60.0f, 180.0f, 180.0f, 360.0f, 540.0f, 0.25f, 0.5f, 8.0f, { 0xC8, 0xC8, 0xC8, 0xFF } }, 
+	// SPARKLE: bursts in every direction from a collected coin.
+	{ 16, { 68, 2, 2, 2 }, 120.0f, 360.0f, 0.0f, 360.0f, 0.0f, 0.33f, 0.67f, 6.0f, { 0xFF, 0xFF, 0xC8, 0xFF } }, 
+	// EMBER: drifts up out of fire.
+	{ 1, { 14, 24, 2, 2 }, 30.0f, 120.0f, 240.0f, 300.0f, -180.0f, 0.5f, 1.0f, 6.0f, { 0xFF, 0xA0, 0x40, 0xFF } }
+};
+
+ParticleSystem::ParticleSystem(TextureAtlas* atlas, std::size_t capacity, const RandomStream& random) : 
+	atlas_(atlas), 
+	capacity_(capacity), 
+	count_(0), 
+	x_(capacity), 
+	y_(capacity), 
+	vx_(capacity), 
+	vy_(capacity), 
+	ay_(capacity), 
+	age_(capacity), 
+	life_(capacity), 
+	emitter_(capacity), 
+	vertices_(capacity * 4), 
+	indices_(capacity * 6), 
+	random_(random), 
+	bounds_({ 0, 0, 0, 0 })
+{
+	// Every particle is a quad, the index pattern never changes.
+	for (std::size_t i = 0; i < capacity_; ++i)
+	{
+		const int first = static_cast<int>(i * 4);
+		int* indices = &indices_[i * 6];
+
+		indices[0] = first;
+		indices[1] = first + 1;
+		indices[2] = first + 2;
+		indices[3] = first + 2;
+		indices[4] = first + 3;
+		indices[5] = first;
+	}
+
+	const float atlas_w = static_cast<float>(atlas_->texture_.width_);
+	const float atlas_h = static_cast<float>(atlas_->texture_.height_);
+
+	for (int i = 0; i < static_cast<int>(ParticleEmitter::COUNT); ++i)
+	{
+		const SDL_Rect& clip = emitter_defs[i].clip;
+		const SDL_Rect atlas_clip = atlas_->Clip(AtlasRegion::OBJECTS, clip.x, clip.y, clip.w, clip.h);
+
+		tex_coords_[i][0] = { atlas_clip.x / atlas_w, atlas_clip.y / atlas_h };
+		tex_coords_[i][1] = { (atlas_clip.x + atlas_clip.w) / atlas_w, (atlas_clip.y + atlas_clip.h) / atlas_h };
+	}
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+void ParticleSystem::Emit(ParticleEmitter emitter, float x, float y)
+{
+	const int index = static_cast<int>(emitter);
+
+	for (int i = 0; i < emitter_defs[index].count; ++i)
+	{
+		Spawn(index, x, y);
+	}
+}
+
+void ParticleSystem::Saturate(ParticleEmitter emitter, std::size_t count, const SDL_Rect& area)
+{
+	count = std::min(count, capacity_);
+
+	while (count_ < count)
+	{
+		Spawn(static_cast<int>(emitter), random_.Uniform(area.x, area.x + area.w), random_.Uniform(area.y, area.y + area.h));
+	}
+}
+
+void ParticleSystem::Tick(float scroll, float dt)
+{
+	const std::size_t count = count_;
+
+	float* x = x_.data();
+	float* y = y_.data();
+	float* vx = vx_.data();
+	float* vy = vy_.data();
+	const float* ay = ay_.data();
+	float* age = age_.data();
+
+	// Straight-line arithmetic over each attribute array, which compilers turn into packed SIMD at -O2.
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		vy[i] += ay[i] * dt;
+		x[i] += (vx[i] - scroll) * dt;
+		y[i] += vy[i] * dt;
+		age[i] += dt;
+	}
+
+	// Dead particles are replaced by the last live one, which keeps the arrays dense.
+	std::size_t i = 0;
+
+	while (i < count_)
+	{
+		if (age_[i] >= life_[i])
+		{
+			const std::size_t last = --count_;
+
+			x_[i] = x_[last];
+			y_[i] = y_[last];
+			vx_[i] = vx_[last];
+			vy_[i] = vy_[last];
+			ay_[i] = ay_[last];
+			age_[i] = age_[last];
+			life_[i] = life_[last];
+			emitter_[i] = emitter_[last];
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if (count_ == 0)
+	{
+		bounds_ = { 0, 0, 0, 0 };
+		return;
+	}
+
+	float min_x = x_[0];
+	float max_x = x_[0];
+	float min_y = y_[0];
+	float max_y = y_[0];
+
+	for (std::size_t j = 1; j < count_; ++j)
+	{
+		min_x = std::min(min_x, x_[j]);
+		max_x = std::max(max_x, x_[j]);
+		min_y = std::min(min_y, y_[j]);
+		max_y = std::max(max_y, y_[j]);
+	}
+
+	float max_size = 0.0f;
+
+	for (const EmitterDef& def : emitter_defs)
+	{
+		max_size = std::max(max_size, def.size);
+	}
+
+	bounds_ = { static_cast<int>(min_x) - 1, static_cast<int>(min_y) - 1, static_cast<int>(max_x - min_x + max_size) + 2, static_cast<int>(max_y - min_y + max_size) + 2 };
+}
+
+void ParticleSystem::Render(SDL_Renderer* renderer)
+{
+	if (count_ == 0)
+	{
+		return;
+	}
+
+	for (std::size_t i = 0; i < count_; ++i)
+	{
+		const int emitter = emitter_[i];
+		const EmitterDef& def = emitter_defs[emitter];
+		const SDL_FPoint& uv_min = tex_coords_[emitter][0];
+		const SDL_FPoint& uv_max = tex_coords_[emitter][1];
+
+		SDL_Color color = def.color;
+		color.a = static_cast<Uint8>(def.color.a * (1.0f - age_[i] / life_[i]));
+
+		SDL_Vertex* quad = &vertices_[i * 4];
+
+		quad[0] = { { x_[i], y_[i] }, color, { uv_min.x, uv_min.y } };
+		quad[1] = { { x_[i] + def.size, y_[i] }, color, { uv_max.x, uv_min.y } };
+		quad[2] = { { x_[i] + def.size, y_[i] + def.size }, color, { uv_max.x, uv_max.y } };
+		quad[3] = { { x_[i], y_[i] + def.size }, color, { uv_min.x, uv_max.y } };
+	}
+
+	++Texture::draw_calls_;
+
+	SDL_RenderGeometry(renderer, atlas_->texture_.texture_, vertices_.data(), static_cast<int>(count_ * 4), indices_.data(), static_cast<int>(count_ * 6));
+}
+
+void ParticleSystem::Render(Framebuffer& framebuffer)
+{
+	// The clips are single colored texels, so on the CPU each particle is a tinted square faded by its age.
+	for (std::size_t i = 0; i < count_; ++i)
+	{
+		const EmitterDef& def = emitter_defs[emitter_[i]];
+		const Uint32 alpha = static_cast<Uint32>(def.color.a * (1.0f - age_[i] / life_[i]));
+		const Uint32 color = (alpha << 24) | (def.color.r << 16) | (def.color.g << 8) | def.color.b;
+		const SDL_Rect rect = { static_cast<int>(x_[i]), static_cast<int>(y_[i]), static_cast<int>(def.size), static_cast<int>(def.size) };
+
+		framebuffer.BlendRect(rect, color);
+	}
+}
+
+void ParticleSystem::Clear()
+{
+	count_ = 0;
+	bounds_ = { 0, 0, 0, 0 };
+}
+
+std::size_t ParticleSystem::Count() const
+{
+	return count_;
+}
+
+const SDL_Rect& ParticleSystem::Bounds() const
+{
+	return bounds_;
+}
+
+void ParticleSystem::Spawn(int emitter, float x, float y)
+{
+	if (count_ == capacity_)
+	{
+		return;
+	}
+
+	const EmitterDef& def = emitter_defs[emitter];
+	const float speed = random_.Uniform(def.speed_min, def.speed_max);
+	const float angle = random_.Uniform(def.angle_min, def.angle_max) * 3.14159265f / 180.0f;
+	const std::size_t i = count_++;
+
+	x_[i] = x - def.size / 2.0f;
+	y_[i] = y - def.size / 2.0f;
+	vx_[i] = speed * std::cos(angle);
+	vy_[i] = speed * std::sin(angle);
+	ay_[i] = def.gravity;
+	age_[i] = 0.0f;
+	life_[i] = random_.Uniform(def.life_min, def.life_max);
+	emitter_[i] = static_cast<std::uint8_t>(emitter);
+}
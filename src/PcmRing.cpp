@@ -0,0 +1,57 @@
+#include "PcmRing.hpp"
+
+#include <algorithm>
+
+PcmRing::PcmRing(std::size_t capacity_pow2) : samples_(capacity_pow2), mask_(capacity_pow2 - 1), read_(0), write_(0)
+{
+}
+
+PcmRing::~PcmRing()
+{
+}
+
+std::size_t PcmRing::Write(const std::int16_t* samples, std::size_t count)
+{
+	const std::size_t write = write_.load(std::memory_order_relaxed);
+	const std::size_t read = read_.load(std::memory_order_acquire);
+
+	count = std::min(count, samples_.size() - (write - read));
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		samples_[(write + i) & mask_] = samples[i];
+	}
+
+	write_.store(write + count, std::memory_order_release);
+
+	return count;
+}
+
+std::size_t PcmRing::Read(std::int16_t* samples, std::size_t count)
+{
+	const std::size_t read = read_.load(std::memory_order_relaxed);
+	const std::size_t write = write_.load(std::memory_order_acquire);
+
+	count = std::min(count, write - read);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		samples[i] = samples_[(read + i) & mask_];
+	}
+
+	read_.store(read + count, std::memory_order_release);
+
+	return count;
+}
+
+std::size_t PcmRing::Free() const
+{
+	return samples_.size() - (write_.load(std::memory_order_relaxed) - read_.load(std::memory_order_acquire));
+}
+
+void PcmRing::Reset()
+{
+	// Only valid while the consumer is known not to be reading.
+	read_.store(0, std::memory_order_relaxed);
+	write_.store(0, std::memory_order_release);
+}
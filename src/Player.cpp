@@ -6,39 +6,20 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
-Player::Player(Game* game) : game_(game)
+Player::Player(Game* game, TextureAtlas* atlas) : game_(game), atlas_(atlas)
 {
-	bounding_box_.x = constants::screen_width / 5.0;
-	bounding_box_.y = constants::screen_height / 5.0;
-	bounding_box_.w = 60.0;
-	bounding_box_.h = 140.0;
-
-	grounded_ = false;
 	speed_ = 10.0;
-	vy_ = 0.0;
-	ay_ = 0.0;
-	mass_ = 3.0;
-	Fy_ = 0.0;
-	Fy_net_ = 0.0;
-
-	frame_ = 0;
+	mass_ = Fixed::FromInt(3);
+	scale_ = constants::player_scale;
 
-	sprite_clips_[0].x = 0;
-	sprite_clips_[0].y = 0;
-	sprite_clips_[0].w = 15;
-	sprite_clips_[0].h = 35;
+	sprite_clips_[0] = SpriteClip(*atlas_, 0);
+	sprite_clips_[1] = SpriteClip(*atlas_, 1);
 
-	sprite_clips_[1].x = 15;
-	sprite_clips_[1].y = 0;
-	sprite_clips_[1].w = 15;
-	sprite_clips_[1].h = 35;
-
-	current_clip_ = &sprite_clips_[0];
-
-	texture_ = std::make_unique<Texture>();
-	texture_->LoadFromPath(game_->renderer_, "res/gfx/player.png");
+	Reset();
 
 	jump_sfx_ = Mix_LoadWAV("res/sfx/jump.wav");
 	pickup_sfx_ = Mix_LoadWAV("res/sfx/pickup.wav");
@@ -46,11 +27,6 @@ Player::Player(Game* game) : game_(game)
 
 Player::~Player()
 {
-	if (texture_ != nullptr)
-	{		
-		texture_->FreeTexture();
-	}
-
 	Mix_FreeChunk(jump_sfx_);
 	jump_sfx_ = nullptr;
 
@@ -58,6 +34,25 @@ Player::~Player()
 	pickup_sfx_ = nullptr;
 }
 
+void Player::Reset()
+{
+	bounding_box_.x = constants::screen_width / 5;
+	bounding_box_.y = constants::screen_height / 5;
+	bounding_box_.w = 60;
+	bounding_box_.h = 140;
+	y_ = Fixed::FromInt(bounding_box_.y);
+	previous_y_ = y_;
+
+	grounded_ = false;
+	vy_ = Fixed::FromInt(0);
+	ay_ = Fixed::FromInt(0);
+	Fy_ = Fixed::FromInt(0);
+	Fy_net_ = Fixed::FromInt(0);
+
+	frame_ = 0;
+	current_clip_ = &sprite_clips_[0];
+}
+
 void Player::HandleEvent(SDL_Event* e)
 {
 	if (e->type == SDL_KEYDOWN)
@@ -70,7 +65,7 @@ void Player::HandleEvent(SDL_Event* e)
 		if ((e->key.keysym.sym == SDLK_SPACE || e->key.keysym.sym == SDLK_UP) && grounded_)
 		{
 			Mix_PlayChannel(-1, jump_sfx_, 0);
-			vy_ = -30.0;
+			vy_ = -game_->jump_velocity_per_tick_;
 		}
 	}
 	else if (e->type == SDL_KEYUP && e->key.repeat == 0)
@@ -85,23 +80,37 @@ void Player::HandleEvent(SDL_Event* e)
 void Player::Tick()
 {
 	const int background_without_ground_h = 640;
-	const float weight = mass_ * constants::g;
+	// Velocities are per tick and accelerations per tick squared. The position step is the exact one for constant
+	// acceleration, so the jump reaches the same height at every tick rate; updating velocity first would overshoot
+	// it by half a tick's worth of velocity.
+	const Fixed weight = mass_ * game_->gravity_per_tick_;
 	Fy_net_ = Fy_ + weight;
 
 	ay_ = Fy_net_ / mass_;
+
+	previous_y_ = y_;
+	y_ += vy_ + Fixed::FromRaw(ay_.raw / 2);
 	vy_ += ay_;
+	bounding_box_.y = y_.Floor();
 
-	bounding_box_.y += vy_;
+	const bool was_grounded = grounded_;
 	grounded_ = Grounded();
 
 	if (grounded_)
 	{
 		bounding_box_.y = background_without_ground_h - bounding_box_.h;
-		ay_ = 0.0;
-		vy_ = 0.0;
+		y_ = Fixed::FromInt(bounding_box_.y);
+		ay_ = Fixed::FromInt(0);
+		vy_ = Fixed::FromInt(0);
+
+		if (!was_grounded)
+		{
+			game_->particles_->Emit(ParticleEmitter::DUST, bounding_box_.x + bounding_box_.w / 2.0f, bounding_box_.y + bounding_box_.h);
+		}
 	}
 
-	const int frame_divisor = 16;
+	// The walk cycle switches sprites every 16 ticks at the default tick rate.
+	const int frame_divisor = std::max(1, 16 * game_->tick_rate_ / constants::tick_rate);
 
 	current_clip_ = &sprite_clips_[frame_ / frame_divisor];
 
@@ -112,20 +121,45 @@ void Player::Tick()
 		frame_ = 0;
 	}
 
+	const SDL_Rect player_rect = CollisionBox();
+
+	obstacle_boxes_.Clear();
+
 	for (const std::unique_ptr<Obstacle>& obstacle : game_->obstacles_)
 	{
-		if (Collides(obstacle->bounding_box_))
+		obstacle_boxes_.Add(obstacle->bounding_box_);
+	}
+
+	// The boxes only select candidates, a hit needs an opaque pixel of the player on an opaque pixel of the obstacle.
+	const std::uint64_t touched = obstacle_boxes_.Overlaps(player_rect);
+
+	for (std::size_t i = 0; i < game_->obstacles_.size(); ++i)
+	{
+		if (((touched >> i) & 1) && MaskOverlaps(player_rect, *game_->obstacles_[i]))
 		{
 			game_->Stop();
+			break;
 		}
 	}
 
+	bonus_item_boxes_.Clear();
+
 	for (const std::unique_ptr<BonusItem>& bonus_item : game_->bonus_items_)
 	{
-		if (Collides(bonus_item->bounding_box_))
+		bonus_item_boxes_.Add(bonus_item->bounding_box_);
+	}
+
+	const std::uint64_t collected = bonus_item_boxes_.Overlaps(player_rect);
+
+	for (std::size_t i = 0; i < game_->bonus_items_.size(); ++i)
+	{
+		if (((collected >> i) & 1) && MaskOverlaps(player_rect, *game_->bonus_items_[i]))
 		{
+			const SDL_Rect& coin = game_->bonus_items_[i]->bounding_box_;
+
 			Mix_PlayChannel(-1, pickup_sfx_, 0);
-			bonus_item->Respawn();
+			game_->particles_->Emit(ParticleEmitter::SPARKLE, coin.x + coin.w / 2.0f, coin.y + coin.h / 2.0f);
+			game_->bonus_items_[i]->Respawn();
 			game_->score_ += 5;
 		}
 	}
@@ -135,20 +169,80 @@ void Player::Tick()
 
 void Player::Render()
 {
-	texture_->Render(game_->renderer_, bounding_box_.x, bounding_box_.y, current_clip_, 4.0);
+	atlas_->texture_.Render(game_->renderer_, bounding_box_.x, RenderY(), current_clip_, scale_);
 
 	// SDL_SetRenderDrawColor(game_->renderer_, 0xFF, 0x00, 0x00, 0xFF);
 	// SDL_RenderDrawRectF(game_->renderer_, &bounding_box_);
 }
 
+void Player::TrackDamage(DamageTracker& damage_tracker) const
+{
+	const SDL_Rect render_rect = { bounding_box_.x, RenderY(), static_cast<int>(current_clip_->w * scale_), static_cast<int>(current_clip_->h * scale_) };
+	damage_tracker.Track(render_rect, DamageTracker::ClipTag(*current_clip_));
+}
+
+int Player::RenderY() const
+{
+	return static_cast<int>(std::floor(previous_y_.ToFloat() + (y_ - previous_y_).ToFloat() * game_->render_alpha_));
+}
+
 bool Player::Grounded()
 {
 	return (bounding_box_.y + bounding_box_.h) >= game_->background_without_ground_h_;
 }
 
-bool Player::Collides(const SDL_Rect& obstacle_rect)
+bool Player::IsGrounded() const
+{
+	return grounded_;
+}
+
+const SDL_Rect& Player::BoundingBox() const
+{
+	return bounding_box_;
+}
+
+void Player::SaveState(PlayerState& state) const
 {
-	SDL_Rect player_rect = { static_cast<int>(bounding_box_.x), static_cast<int>(bounding_box_.y), static_cast<int>(bounding_box_.w), static_cast<int>(bounding_box_.h) };
+	state.bounding_box = bounding_box_;
+	state.y = y_;
+	state.vy = vy_;
+	state.ay = ay_;
+	state.Fy = Fy_;
+	state.frame = frame_;
+	state.clip = static_cast<int>(current_clip_ - sprite_clips_);
+	state.grounded = grounded_;
+}
+
+void Player::LoadState(const PlayerState& state)
+{
+	bounding_box_ = state.bounding_box;
+	y_ = state.y;
+	previous_y_ = state.y;
+	vy_ = state.vy;
+	ay_ = state.ay;
+	Fy_ = state.Fy;
+	frame_ = state.frame;
+	current_clip_ = &sprite_clips_[state.clip];
+	grounded_ = state.grounded;
+}
 
-	return SDL_HasIntersection(&player_rect, &obstacle_rect);
-}
\ No newline at end of file
+bool Player::MaskOverlaps(const SDL_Rect& player_rect, const Entity& entity) const
+{
+	const CollisionMask& mask = game_->player_masks_[current_clip_ - sprite_clips_];
+	return mask.Overlaps(entity.Mask(), entity.bounding_box_.x - player_rect.x, entity.bounding_box_.y - player_rect.y);
+}
+
+SDL_Rect Player::CollisionBox() const
+{
+	return bounding_box_;
+}
+
+SDL_Rect Player::SpriteClip(const TextureAtlas& atlas, int frame)
+{
+	return atlas.Clip(AtlasRegion::PLAYER, frame * 15, 0, 15, 35);
+}
+
+CollisionMask Player::BuildMask(const TextureAtlas& atlas, int frame)
+{
+	return atlas.Mask(SpriteClip(atlas, frame), constants::player_scale);
+}
@@ -0,0 +1,39 @@
+#include "Random.hpp"
+
+static constexpr std::uint64_t golden_gamma = 0x9E3779B97F4A7C15ull;
+
+static std::uint64_t Mix(std::uint64_t z)
+{
+	// The SplitMix64 finalizer, a bijection that spreads every input bit over the whole word.
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+RandomStream RandomStream::Create(std::uint64_t seed, RandomSubsystem subsystem, std::uint32_t index)
+{
+	const std::uint64_t stream = (static_cast<std::uint64_t>(subsystem) << 32) | index;
+	return { Mix(seed ^ Mix(stream * golden_gamma)), 0 };
+}
+
+std::uint64_t RandomStream::At(std::uint64_t key, std::uint64_t counter)
+{
+	// SplitMix64 jumped straight to its counter-th state.
+	return Mix(key + (counter + 1) * golden_gamma);
+}
+
+std::uint64_t RandomStream::Next()
+{
+	return At(key, counter++);
+}
+
+int RandomStream::Below(int bound)
+{
+	// Multiply-shift instead of modulo, no division and no bias worth measuring for small bounds.
+	return static_cast<int>(((Next() >> 32) * static_cast<std::uint64_t>(bound)) >> 32);
+}
+
+float RandomStream::Uniform(float min, float max)
+{
+	return min + (max - min) * (static_cast<float>(Next() >> 40) / static_cast<float>(1 << 24));
+}
@@ -0,0 +1,191 @@
+#include "RectBatch.hpp"
+
+#include <cassert>
+#include <climits>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RECT_BATCH_X86
+#include <immintrin.h>
+#endif
+
+using OverlapKernel = void (*)(const std::int32_t* left, const std::int32_t* top, const std::int32_t* right, const std::int32_t* bottom, std::size_t count, const SDL_Rect& rect, std::uint64_t* mask);
+
+// Same rule as SDL_HasIntersection: the rects overlap when each one starts before the other one ends on both axes.
+static void OverlapScalar(const std::int32_t* left, const std::int32_t* top, const std::int32_t* right, const std::int32_t* bottom, std::size_t count, const SDL_Rect& rect, std::uint64_t* mask)
+{
+	const std::int32_t rect_right = rect.x + rect.w;
+	const std::int32_t rect_bottom = rect.y + rect.h;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const bool hit = rect.x < right[i] && left[i] < rect_right && rect.y < bottom[i] && top[i] < rect_bottom;
+		mask[i / 64] |= static_cast<std::uint64_t>(hit) << (i % 64);
+	}
+}
+
+#ifdef RECT_BATCH_X86
+
+__attribute__((target("sse2")))
+static void OverlapSSE2(const std::int32_t* left, const std::int32_t* top, const std::int32_t* right, const std::int32_t* bottom, std::size_t count, const SDL_Rect& rect, std::uint64_t* mask)
+{
+	const __m128i rect_left = _mm_set1_epi32(rect.x);
+	const __m128i rect_top = _mm_set1_epi32(rect.y);
+	const __m128i rect_right = _mm_set1_epi32(rect.x + rect.w);
+	const __m128i rect_bottom = _mm_set1_epi32(rect.y + rect.h);
+
+	for (std::size_t i = 0; i < count; i += 4)
+	{
+		const __m128i x_hit = _mm_and_si128(_mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i)), rect_left), _mm_cmpgt_epi32(rect_right, _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i))));
+		const __m128i y_hit = _mm_and_si128(_mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i)), rect_top), _mm_cmpgt_epi32(rect_bottom, _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i))));
+		const std::uint64_t bits = static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(x_hit, y_hit))));
+
+		mask[i / 64] |= bits << (i % 64);
+	}
+}
+
+__attribute__((target("avx2")))
+static void OverlapAVX2(const std::int32_t* left, const std::int32_t* top, const std::int32_t* right, const std::int32_t* bottom, std::size_t count, const SDL_Rect& rect, std::uint64_t* mask)
+{
+	const __m256i rect_left = _mm256_set1_epi32(rect.x);
+	const __m256i rect_top = _mm256_set1_epi32(rect.y);
+	const __m256i rect_right = _mm256_set1_epi32(rect.x + rect.w);
+	const __m256i rect_bottom = _mm256_set1_epi32(rect.y + rect.h);
+
+	for (std::size_t i = 0; i < count; i += 8)
+	{
+		const __m256i x_hit = _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i)), rect_left), _mm256_cmpgt_epi32(rect_right, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i))));
+		const __m256i y_hit = _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + i)), rect_top), _mm256_cmpgt_epi32(rect_bottom, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + i))));
+		const std::uint64_t bits = static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(x_hit, y_hit))));
+
+		mask[i / 64] |= bits << (i % 64);
+	}
+}
+
+#endif
+
+static OverlapKernel SelectKernel(const char*& name)
+{
+#ifdef RECT_BATCH_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		name = "AVX2";
+		return OverlapAVX2;
+	}
+
+	if (__builtin_cpu_supports("sse2"))
+	{
+		name = "SSE2";
+		return OverlapSSE2;
+	}
+#endif
+
+	name = "scalar";
+	return OverlapScalar;
+}
+
+static const char* kernel_name = nullptr;
+static OverlapKernel overlap_kernel = SelectKernel(kernel_name);
+
+RectBatch::RectBatch() : size_(0)
+{
+}
+
+RectBatch::~RectBatch()
+{
+}
+
+void RectBatch::Clear()
+{
+	left_.clear();
+	top_.clear();
+	right_.clear();
+	bottom_.clear();
+	size_ = 0;
+}
+
+void RectBatch::Add(const SDL_Rect& rect)
+{
+	const std::size_t padded_size = (size_ / lanes + 1) * lanes;
+
+	if (left_.size() < padded_size)
+	{
+		// Padding lanes end before they start, so they never overlap anything.
+		left_.resize(padded_size, INT_MAX);
+		top_.resize(padded_size, INT_MAX);
+		right_.resize(padded_size, INT_MIN);
+		bottom_.resize(padded_size, INT_MIN);
+	}
+
+	if (rect.w > 0 && rect.h > 0)
+	{
+		left_[size_] = rect.x;
+		top_[size_] = rect.y;
+		right_[size_] = rect.x + rect.w;
+		bottom_[size_] = rect.y + rect.h;
+	}
+
+	++size_;
+}
+
+std::size_t RectBatch::Size() const
+{
+	return size_;
+}
+
+void RectBatch::Overlaps(const SDL_Rect& rect, std::uint64_t* mask) const
+{
+	std::memset(mask, 0, ((size_ + 63) / 64) * sizeof(std::uint64_t));
+
+	if (size_ == 0 || rect.w <= 0 || rect.h <= 0)
+	{
+		return;
+	}
+
+	overlap_kernel(left_.data(), top_.data(), right_.data(), bottom_.data(), left_.size(), rect, mask);
+}
+
+std::uint64_t RectBatch::Overlaps(const SDL_Rect& rect) const
+{
+	assert(size_ <= 64);
+
+	std::uint64_t mask = 0;
+	Overlaps(rect, &mask);
+
+	return mask;
+}
+
+const char* RectBatch::KernelName()
+{
+	return kernel_name;
+}
+
+bool RectBatch::UseKernel(const char* name)
+{
+	if (std::strcmp(name, "scalar") == 0)
+	{
+		kernel_name = "scalar";
+		overlap_kernel = OverlapScalar;
+		return true;
+	}
+
+#ifdef RECT_BATCH_X86
+	if (std::strcmp(name, "SSE2") == 0 && __builtin_cpu_supports("sse2"))
+	{
+		kernel_name = "SSE2";
+		overlap_kernel = OverlapSSE2;
+		return true;
+	}
+
+	if (std::strcmp(name, "AVX2") == 0 && __builtin_cpu_supports("avx2"))
+	{
+		kernel_name = "AVX2";
+		overlap_kernel = OverlapAVX2;
+		return true;
+	}
+#endif
+
+	return false;
+}
@@ -0,0 +1,66 @@
+#include "Snapshot.hpp"
+
+static std::uint64_t Hash(std::uint64_t hash, const void* data, std::size_t size)
+{
+	// FNV-1a, fields are hashed one by one so padding bytes never end up in the result.
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+template <typename T>
+static std::uint64_t Hash(std::uint64_t hash, const T& value)
+{
+	return Hash(hash, &value, sizeof(value));
+}
+
+static std::uint64_t Hash(std::uint64_t hash, const EntityState& entity)
+{
+	hash = Hash(hash, entity.bounding_box.x);
+	hash = Hash(hash, entity.bounding_box.y);
+	hash = Hash(hash, entity.bounding_box.w);
+	hash = Hash(hash, entity.bounding_box.h);
+	hash = Hash(hash, entity.x.raw);
+	hash = Hash(hash, entity.type);
+	hash = Hash(hash, entity.random.key);
+	return Hash(hash, entity.random.counter);
+}
+
+std::uint64_t Snapshot::Checksum() const
+{
+	std::uint64_t hash = 0xCBF29CE484222325ull;
+
+	hash = Hash(hash, tick_count);
+	hash = Hash(hash, score);
+	hash = Hash(hash, scrolling_speed);
+	hash = Hash(hash, ground_scrolling_offset.raw);
+	hash = Hash(hash, game_over);
+
+	hash = Hash(hash, player.bounding_box.x);
+	hash = Hash(hash, player.bounding_box.y);
+	hash = Hash(hash, player.y.raw);
+	hash = Hash(hash, player.vy.raw);
+	hash = Hash(hash, player.ay.raw);
+	hash = Hash(hash, player.Fy.raw);
+	hash = Hash(hash, player.frame);
+	hash = Hash(hash, player.clip);
+	hash = Hash(hash, player.grounded);
+
+	for (const EntityState& obstacle : obstacles)
+	{
+		hash = Hash(hash, obstacle);
+	}
+
+	for (const EntityState& bonus_item : bonus_items)
+	{
+		hash = Hash(hash, bonus_item);
+	}
+
+	return hash;
+}
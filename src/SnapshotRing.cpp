@@ -0,0 +1,48 @@
+#include "SnapshotRing.hpp"
+
+#include <algorithm>
+
+SnapshotRing::SnapshotRing(std::size_t capacity) : snapshots_(capacity), head_(0), size_(0)
+{
+}
+
+SnapshotRing::~SnapshotRing()
+{
+}
+
+Snapshot& SnapshotRing::Push()
+{
+	Snapshot& snapshot = snapshots_[head_];
+
+	head_ = (head_ + 1) % snapshots_.size();
+	size_ = std::min(size_ + 1, snapshots_.size());
+
+	return snapshot;
+}
+
+const Snapshot* SnapshotRing::Rewind(std::size_t ticks)
+{
+	if (size_ == 0)
+	{
+		return nullptr;
+	}
+
+	// Snapshots newer than the one rewound to are dropped, playing on overwrites them.
+	ticks = std::min(ticks, size_ - 1);
+
+	head_ = (head_ + snapshots_.size() - ticks) % snapshots_.size();
+	size_ -= ticks;
+
+	return &snapshots_[(head_ + snapshots_.size() - 1) % snapshots_.size()];
+}
+
+void SnapshotRing::Clear()
+{
+	head_ = 0;
+	size_ = 0;
+}
+
+std::size_t SnapshotRing::Size() const
+{
+	return size_;
+}
@@ -1,10 +1,13 @@
 #include "Texture.hpp"
+#include "AllocationTracker.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 
-Texture::Texture() : texture_(nullptr), width_(0), height_(0)
+int Texture::draw_calls_ = 0;
+
+Texture::Texture() : texture_(nullptr), surface_(nullptr), framebuffer_(nullptr), width_(0), height_(0)
 {
 }
 
@@ -22,14 +25,21 @@ void Texture::FreeTexture()
 		width_ = 0;
 		height_ = 0;
 	}
+
+	if (surface_ != nullptr)
+	{
+		SDL_FreeSurface(surface_);
+		surface_ = nullptr;
+		width_ = 0;
+		height_ = 0;
+	}
 }
 
 bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
 {
 	FreeTexture();
 
-	SDL_Texture* tmp_texture = nullptr;
-	SDL_Surface* loaded_surface = IMG_Load(path);
+	SDL_Surface* loaded_surface = AllocationTracker::CountSurface(IMG_Load(path));
 
 	if (loaded_surface == nullptr)
 	{
@@ -39,29 +49,56 @@ bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
 
 	SDL_SetColorKey(loaded_surface, SDL_TRUE, SDL_MapRGB(loaded_surface->format, 0xFF, 0x00, 0xFF));
 
-	tmp_texture = SDL_CreateTextureFromSurface(renderer, loaded_surface);
+	if (!LoadFromSurface(renderer, loaded_surface))
+	{
+		printf("Unable to create texture from %s!\n", path);
+	}
+
+	SDL_FreeSurface(loaded_surface);
+
+	return texture_ != nullptr || surface_ != nullptr;
+}
+
+bool Texture::LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+	FreeTexture();
 
-	if (tmp_texture == nullptr)
+	if (framebuffer_ != nullptr)
 	{
-		printf("Unable to create texture from %s! SDL Error: %s\n", path, SDL_GetError());
+		// Converting also turns a color key into zero alpha, which is what the framebuffer blits test for.
+		surface_ = AllocationTracker::CountSurface(SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0));
+
+		if (surface_ == nullptr)
+		{
+			printf("Unable to convert surface for the framebuffer! SDL Error: %s\n", SDL_GetError());
+			return false;
+		}
+
+		width_ = surface->w;
+		height_ = surface->h;
+
+		return true;
 	}
-	else
+
+	texture_ = AllocationTracker::CountTexture(SDL_CreateTextureFromSurface(renderer, surface));
+
+	if (texture_ == nullptr)
 	{
-		width_ = loaded_surface->w;
-		height_ = loaded_surface->h;
+		printf("Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
+		return false;
 	}
 
-	SDL_FreeSurface(loaded_surface);
-	texture_ = tmp_texture;
+	width_ = surface->w;
+	height_ = surface->h;
 
-	return texture_ != nullptr;
+	return true;
 }
 
 bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& text_color, int text_length)
 {
 	FreeTexture();
 
-	SDL_Surface* text_surface = text_length == -1 ? TTF_RenderText_Blended(font, text, text_color) : TTF_RenderText_Blended_Wrapped(font, text, text_color, text_length);
+	SDL_Surface* text_surface = AllocationTracker::CountSurface(text_length == -1 ? TTF_RenderText_Blended(font, text, text_color) : TTF_RenderText_Blended_Wrapped(font, text, text_color, text_length));
 
 	if (text_surface == nullptr)
 	{
@@ -69,23 +106,21 @@ bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* t
 		return false;
 	}
 
-	texture_ = SDL_CreateTextureFromSurface(renderer, text_surface);
+	const bool success = LoadFromSurface(renderer, text_surface);
 
-	if (texture_ == nullptr)
+	if (!success)
 	{
-		printf("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
-		SDL_FreeSurface(text_surface);
-		return false;
+		printf("%s\n", "Unable to create texture from rendered text!");
 	}
 
-	width_ = text_surface->w;
-	height_ = text_surface->h;
 	SDL_FreeSurface(text_surface);
-	return true;
+	return success;
 }
 
 void Texture::Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, float scale)
 {
+	++draw_calls_;
+
 	SDL_Rect render_rect = { x, y, width_, height_ };
 
 	if (clip != nullptr)
@@ -94,5 +129,12 @@ void Texture::Render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, float
 		render_rect.h = clip->h * scale;
 	}
 
+	if (framebuffer_ != nullptr)
+	{
+		const SDL_Rect source_rect = clip != nullptr ? *clip : SDL_Rect{ 0, 0, width_, height_ };
+		framebuffer_->Blit(surface_, source_rect, render_rect);
+		return;
+	}
+
 	SDL_RenderCopy(renderer, texture_, clip, &render_rect);
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "TextureAtlas.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <algorithm>
+#include <numeric>
+
+TextureAtlas::TextureAtlas()
+{
+	for (SDL_Rect& region : regions_)
+	{
+		region = { 0, 0, 0, 0 };
+	}
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+bool TextureAtlas::Load(SDL_Renderer* renderer)
+{
+	constexpr int count = static_cast<int>(AtlasRegion::COUNT);
+	constexpr const char* paths[count] = { "res/gfx/background.png", "res/gfx/objects.png", "res/gfx/player.png" };
+	constexpr int padding = 1;
+
+	SDL_Surface* surfaces[count] = { nullptr };
+	bool success = true;
+
+	for (int i = 0; i < count; ++i)
+	{
+		surfaces[i] = IMG_Load(paths[i]);
+
+		if (surfaces[i] == nullptr)
+		{
+			printf("Unable to load image %s! SDL_image Error: %s\n", paths[i], IMG_GetError());
+			success = false;
+		}
+	}
+
+	int atlas_w = 0;
+	int atlas_h = 0;
+
+	SDL_Surface* atlas_surface = nullptr;
+
+	if (success)
+	{
+		success = Pack(surfaces, regions_, count, padding, atlas_w, atlas_h);
+	}
+
+	if (success)
+	{
+		atlas_surface = SDL_CreateRGBSurfaceWithFormat(0, atlas_w, atlas_h, 32, SDL_PIXELFORMAT_RGBA32);
+
+		if (atlas_surface == nullptr)
+		{
+			printf("Unable to create %dx%d atlas surface! SDL Error: %s\n", atlas_w, atlas_h, SDL_GetError());
+			success = false;
+		}
+	}
+
+	if (success)
+	{
+		long used_area = 0;
+
+		for (int i = 0; i < count; ++i)
+		{
+			// Copy pixels as-is, except for the magenta color key which stays fully transparent in the atlas.
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_SetColorKey(surfaces[i], SDL_TRUE, SDL_MapRGB(surfaces[i]->format, 0xFF, 0x00, 0xFF));
+			SDL_BlitSurface(surfaces[i], nullptr, atlas_surface, &regions_[i]);
+
+			used_area += static_cast<long>(regions_[i].w) * regions_[i].h;
+		}
+
+		// The color key is gone after packing, zero alpha marks the pixels that cannot be hit.
+		mask_ = OpaquePixels(atlas_surface);
+
+		success = texture_.LoadFromSurface(renderer, atlas_surface);
+
+		if (success)
+		{
+			const long atlas_area = static_cast<long>(atlas_w) * atlas_h;
+			printf("Packed %d images into %dx%d atlas (%.1f%% used)\n", count, atlas_w, atlas_h, 100.0 * used_area / atlas_area);
+		}
+	}
+
+	SDL_FreeSurface(atlas_surface);
+
+	for (SDL_Surface* surface : surfaces)
+	{
+		SDL_FreeSurface(surface);
+	}
+
+	return success;
+}
+
+SDL_Rect TextureAtlas::Clip(AtlasRegion region, int x, int y, int w, int h) const
+{
+	const SDL_Rect& origin = regions_[static_cast<int>(region)];
+	return { origin.x + x, origin.y + y, w, h };
+}
+
+CollisionMask TextureAtlas::Mask(const SDL_Rect& clip, int scale) const
+{
+	return mask_.Scaled(clip, scale);
+}
+
+CollisionMask TextureAtlas::OpaquePixels(SDL_Surface* surface)
+{
+	CollisionMask mask(surface->w, surface->h);
+
+	SDL_LockSurface(surface);
+
+	for (int y = 0; y < surface->h; ++y)
+	{
+		const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + y * surface->pitch);
+
+		for (int x = 0; x < surface->w; ++x)
+		{
+			Uint8 r = 0;
+			Uint8 g = 0;
+			Uint8 b = 0;
+			Uint8 a = 0;
+			SDL_GetRGBA(row[x], surface->format, &r, &g, &b, &a);
+
+			if (a != 0)
+			{
+				mask.Set(x, y);
+			}
+		}
+	}
+
+	SDL_UnlockSurface(surface);
+
+	return mask;
+}
+
+bool TextureAtlas::Pack(SDL_Surface** surfaces, SDL_Rect* regions, int count, int padding, int& atlas_w, int& atlas_h)
+{
+	int order[static_cast<int>(AtlasRegion::COUNT)];
+	std::iota(order, order + count, 0);
+
+	// Shelf packing: tallest images first, each shelf as high as its first image.
+	std::sort(order, order + count, [surfaces](int a, int b)
+	{
+		return surfaces[a]->h > surfaces[b]->h;
+	});
+
+	atlas_w = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		atlas_w = std::max(atlas_w, surfaces[i]->w);
+	}
+
+	int shelf_x = 0;
+	int shelf_y = 0;
+	int shelf_h = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		const SDL_Surface* surface = surfaces[order[i]];
+
+		if (shelf_x + surface->w > atlas_w)
+		{
+			shelf_x = 0;
+			shelf_y += shelf_h + padding;
+			shelf_h = 0;
+		}
+
+		regions[order[i]] = { shelf_x, shelf_y, surface->w, surface->h };
+
+		shelf_x += surface->w + padding;
+		shelf_h = std::max(shelf_h, surface->h);
+	}
+
+	atlas_h = shelf_y + shelf_h;
+
+	return atlas_w > 0 && atlas_h > 0;
+}
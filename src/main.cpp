@@ -1,15 +1,19 @@
 #include "Game.hpp"
+#include "Options.hpp"
 
 #include <iostream>
 #include <memory>
 
 int main(int argc, char* argv[])
 {
-	(void) argc;
-	(void) argv;
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
 	
-	std::unique_ptr<Game> game = std::make_unique<Game>();
-	game->Run();
+	std::unique_ptr<Game> game = std::make_unique<Game>(options);
 
-	return 0;
+	return game->Run() ? 0 : 1;
 }
@@ -0,0 +1,650 @@
+#include "RectBatch.hpp"
+#include "CollisionMask.hpp"
+#include "Random.hpp"
+#include "ParticleSystem.hpp"
+#include "Framebuffer.hpp"
+#include "Constants.hpp"
+#include "Game.hpp"
+#include "Options.hpp"
+#include "SnapshotRing.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Microbenchmarks for the hot loops of the game, built with the same flags as the game by `make bench`.
+// `./bench` runs all of them, `./bench rects` only the named ones.
+
+using BenchClock = std::chrono::steady_clock;
+
+// Keeps results alive so the optimizer cannot drop the loops that produce them.
+static volatile std::uint64_t sink = 0;
+
+static double NanosecondsPer(BenchClock::time_point start, double count)
+{
+	return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count() / count;
+}
+
+// One rect against n rects scattered over a 2000x2000 area: SDL_HasIntersection per pair, then every RectBatch kernel.
+static void BenchRects()
+{
+	const char* kernels[] = { "scalar", "SSE2", "AVX2" };
+	const char* selected = RectBatch::KernelName();
+
+	printf("%s\n", "rects: ns per rect pair");
+	printf("%9s %10s %8s %8s %8s\n", "rects", "SDL", "scalar", "SSE2", "AVX2");
+
+	for (const int count : { 16, 256, 4096, 65536, 1 << 20 })
+	{
+		RectBatch batch;
+		std::vector<SDL_Rect> rects;
+
+		for (int i = 0; i < count; ++i)
+		{
+			const std::uint64_t bits = RandomStream::At(1, i);
+			const SDL_Rect rect = { static_cast<int>(bits % 2000), static_cast<int>((bits >> 16) % 2000), static_cast<int>(1 + (bits >> 32) % 128), static_cast<int>(1 + (bits >> 48) % 128) };
+			rects.push_back(rect);
+			batch.Add(rect);
+		}
+
+		const SDL_Rect player = { 192, 500, 60, 140 };
+		const int repeats = std::max(1, (1 << 24) / count);
+		std::vector<std::uint64_t> mask((count + 63) / 64);
+
+		BenchClock::time_point start = BenchClock::now();
+
+		for (int r = 0; r < repeats; ++r)
+		{
+			std::uint64_t hits = 0;
+
+			for (const SDL_Rect& rect : rects)
+			{
+				hits += SDL_HasIntersection(&player, &rect);
+			}
+
+			sink = sink + hits;
+		}
+
+		printf("%9d %10.3f", count, NanosecondsPer(start, static_cast<double>(repeats) * count));
+
+		for (const char* kernel : kernels)
+		{
+			if (!RectBatch::UseKernel(kernel))
+			{
+				printf(" %8s", "n/a");
+				continue;
+			}
+
+			start = BenchClock::now();
+
+			for (int r = 0; r < repeats; ++r)
+			{
+				batch.Overlaps(player, mask.data());
+				sink = sink + mask[0];
+			}
+
+			printf(" %8.3f", NanosecondsPer(start, static_cast<double>(repeats) * count));
+		}
+
+		printf("\n");
+	}
+
+	RectBatch::UseKernel(selected);
+}
+
+// Keeps n sparkles alive like --particle-stress: one tick of updates, then one full-screen draw on the CPU rasterizer
+// and one through SDL_RenderGeometry, the default path, on a software renderer with the game's atlas.
+static void BenchParticles()
+{
+	printf("%s\n", "particles: ms per tick, per CPU rasterizer frame and per SDL_RenderGeometry frame");
+	printf("%9s %10s %10s %10s\n", "particles", "tick", "cpu draw", "sdl draw");
+
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, constants::screen_width, constants::screen_height, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+
+	if (renderer == nullptr)
+	{
+		printf("Unable to create software renderer! SDL Error: %s\n", SDL_GetError());
+		return;
+	}
+
+	// The atlas gives the quads their texture coordinates, so it has to be loaded before the particle systems are made.
+	TextureAtlas atlas;
+
+	if (!atlas.Load(renderer))
+	{
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(target);
+		return;
+	}
+
+	Framebuffer framebuffer(constants::screen_width, constants::screen_height);
+	const SDL_Rect area = { 0, 0, constants::screen_width, 640 };
+	const float dt = 1.0f / constants::tick_rate;
+
+	for (const std::size_t count : { 1000, 10000, 100000 })
+	{
+		ParticleSystem particles(&atlas, count, RandomStream::Create(1, RandomSubsystem::PARTICLES, 0));
+		const int repeats = static_cast<int>(std::max<std::size_t>(10, 2000000 / count));
+
+		double tick_ms = 0.0;
+		double cpu_draw_ms = 0.0;
+		double sdl_draw_ms = 0.0;
+
+		for (int r = 0; r < repeats; ++r)
+		{
+			particles.Saturate(ParticleEmitter::SPARKLE, count, area);
+
+			BenchClock::time_point start = BenchClock::now();
+			particles.Tick(constants::scrolling_speed, dt);
+			tick_ms += NanosecondsPer(start, 1e6);
+
+			start = BenchClock::now();
+			particles.Render(framebuffer);
+			cpu_draw_ms += NanosecondsPer(start, 1e6);
+
+			// Draw calls are queued, flushing runs them into the target surface.
+			start = BenchClock::now();
+			particles.Render(renderer);
+			SDL_RenderFlush(renderer);
+			sdl_draw_ms += NanosecondsPer(start, 1e6);
+		}
+
+		sink = sink + framebuffer.Pixels()[0] + static_cast<const Uint32*>(target->pixels)[0];
+		printf("%9zu %10.3f %10.3f %10.3f\n", count, tick_ms / repeats, cpu_draw_ms / repeats, sdl_draw_ms / repeats);
+	}
+
+	atlas.texture_.FreeTexture();
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+}
+
+// An ellipse filling a w x h box, the shape of the sprites whose corners are transparent.
+static CollisionMask MakeEllipse(int w, int h)
+{
+	CollisionMask mask(w, h);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			const double nx = (2.0 * x + 1.0) / w - 1.0;
+			const double ny = (2.0 * y + 1.0) / h - 1.0;
+
+			if (nx * nx + ny * ny <= 1.0)
+			{
+				mask.Set(x, y);
+			}
+		}
+	}
+
+	return mask;
+}
+
+static bool PixelsOverlap(const CollisionMask& a, const CollisionMask& b, int dx, int dy)
+{
+	for (int y = 0; y < a.Height(); ++y)
+	{
+		for (int x = 0; x < a.Width(); ++x)
+		{
+			const int bx = x - dx;
+			const int by = y - dy;
+
+			if (a.Get(x, y) && bx >= 0 && by >= 0 && bx < b.Width() && by < b.Height() && b.Get(bx, by))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// The player's 60x140 box against a 64x64 sprite at every offset where the boxes overlap, the narrow phase Player::Tick
+// runs after the AABB kernel. Dense pairs hit on an early row, near misses scan the whole shared area and find nothing.
+static void BenchMasks()
+{
+	const CollisionMask player = MakeEllipse(60, 140);
+	const CollisionMask sprite = MakeEllipse(64, 64);
+	const SDL_Rect player_rect = { 0, 0, 60, 140 };
+
+	std::vector<SDL_Point> dense;
+	std::vector<SDL_Point> near_misses;
+	long mismatches = 0;
+
+	for (int dy = -63; dy < 140; ++dy)
+	{
+		for (int dx = -63; dx < 60; ++dx)
+		{
+			const bool hit = player.Overlaps(sprite, dx, dy);
+			mismatches += hit != PixelsOverlap(player, sprite, dx, dy);
+			(hit ? dense : near_misses).push_back({ dx, dy });
+		}
+	}
+
+	printf("%s\n", "masks: ns per candidate pair");
+	printf("%12s %8s %8s %8s\n", "pairs", "count", "AABB", "mask");
+
+	const std::vector<SDL_Point>* sets[] = { &dense, &near_misses };
+	const char* names[] = { "dense", "near miss" };
+	const int repeats = 200;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const std::vector<SDL_Point>& offsets = *sets[i];
+
+		BenchClock::time_point start = BenchClock::now();
+
+		for (int r = 0; r < repeats; ++r)
+		{
+			std::uint64_t hits = 0;
+
+			for (const SDL_Point& offset : offsets)
+			{
+				const SDL_Rect rect = { offset.x, offset.y, 64, 64 };
+				hits += SDL_HasIntersection(&player_rect, &rect);
+			}
+
+			sink = sink + hits;
+		}
+
+		const double aabb_ns = NanosecondsPer(start, static_cast<double>(repeats) * offsets.size());
+
+		start = BenchClock::now();
+
+		for (int r = 0; r < repeats; ++r)
+		{
+			std::uint64_t hits = 0;
+
+			for (const SDL_Point& offset : offsets)
+			{
+				hits += player.Overlaps(sprite, offset.x, offset.y);
+			}
+
+			sink = sink + hits;
+		}
+
+		printf("%12s %8zu %8.3f %8.3f\n", names[i], offsets.size(), aabb_ns, NanosecondsPer(start, static_cast<double>(repeats) * offsets.size()));
+	}
+
+	printf("%ld of %zu offsets disagree with a per-pixel test\n", mismatches, dense.size() + near_misses.size());
+}
+
+static SDL_Surface* MakeSurface(int w, int h, bool color_keyed)
+{
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+
+	for (int y = 0; y < h; ++y)
+	{
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+
+		for (int x = 0; x < w; ++x)
+		{
+			// Sprites have transparent holes the way color-keyed sheets do after loading, backgrounds are opaque.
+			const bool hole = color_keyed && (x / 3 + y / 5) % 4 == 0;
+			row[x] = hole ? 0x00000000 : 0xFF000000 | static_cast<Uint32>(RandomStream::At(2, static_cast<std::uint64_t>(y) * w + x) & 0xFFFFFF);
+		}
+	}
+
+	return surface;
+}
+
+// A full redraw shaped like a game frame: the background, two ground strips and eleven color-keyed sprites at 2x and 4x.
+// The CPU rasterizer and SDL's software renderer draw it into same sized ARGB8888 pixels, which are then compared.
+static void BenchRaster()
+{
+	struct Draw
+	{
+		int surface;
+		SDL_Rect source;
+		SDL_Rect destination;
+	};
+
+	SDL_Surface* surfaces[] = { MakeSurface(constants::screen_width, 640, false), MakeSurface(constants::screen_width, 80, false), MakeSurface(64, 64, true), MakeSurface(15, 35, true) };
+
+	std::vector<Draw> scene = {
+		{ 0, { 0, 0, constants::screen_width, 640 }, { 0, 0, constants::screen_width, 640 } },
+		{ 1, { 0, 0, constants::screen_width, 80 }, { -300, 640, constants::screen_width, 80 } },
+		{ 1, { 0, 0, constants::screen_width, 80 }, { constants::screen_width - 300, 640, constants::screen_width, 80 } },
+		{ 3, { 0, 0, 15, 35 }, { 192, 500, 60, 140 } },
+	};
+
+	for (int i = 0; i < 5; ++i)
+	{
+		scene.push_back({ 2, { 0, 0, 32, 32 }, { 300 + i * 130, 576, 64, 64 } });
+		scene.push_back({ 2, { 32, 32, 16, 16 }, { 330 + i * 130, 400, 32, 32 } });
+	}
+
+	const int frames = 500;
+
+	Framebuffer framebuffer(constants::screen_width, constants::screen_height);
+	BenchClock::time_point start = BenchClock::now();
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		framebuffer.Clear(0xFF000000);
+
+		for (const Draw& draw : scene)
+		{
+			framebuffer.Blit(surfaces[draw.surface], draw.source, draw.destination);
+		}
+	}
+
+	const double framebuffer_ms = NanosecondsPer(start, 1e6 * frames);
+
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, constants::screen_width, constants::screen_height, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+
+	if (renderer == nullptr)
+	{
+		printf("Unable to create software renderer! SDL Error: %s\n", SDL_GetError());
+		return;
+	}
+
+	SDL_Texture* textures[4];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		textures[i] = SDL_CreateTextureFromSurface(renderer, surfaces[i]);
+		SDL_SetTextureBlendMode(textures[i], SDL_BLENDMODE_BLEND);
+	}
+
+	start = BenchClock::now();
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+		SDL_RenderClear(renderer);
+
+		for (const Draw& draw : scene)
+		{
+			SDL_RenderCopy(renderer, textures[draw.surface], &draw.source, &draw.destination);
+		}
+
+		// Draw calls are queued, flushing runs them into the target surface.
+		SDL_RenderFlush(renderer);
+	}
+
+	const double software_ms = NanosecondsPer(start, 1e6 * frames);
+
+	long mismatches = 0;
+
+	for (int y = 0; y < constants::screen_height; ++y)
+	{
+		const Uint32* software_row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(target->pixels) + y * target->pitch);
+		const Uint32* framebuffer_row = framebuffer.Pixels(0, y);
+
+		for (int x = 0; x < constants::screen_width; ++x)
+		{
+			mismatches += (software_row[x] | 0xFF000000) != framebuffer_row[x];
+		}
+	}
+
+	printf("%s\n", "raster: ms per full redraw of a game-like scene");
+	printf("CPU rasterizer %.3f ms, SDL software renderer %.3f ms (%.2fx), %ld of %d pixels differ\n", framebuffer_ms, software_ms, software_ms / framebuffer_ms, mismatches, constants::screen_width * constants::screen_height);
+
+	for (SDL_Texture* texture : textures)
+	{
+		SDL_DestroyTexture(texture);
+	}
+
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+
+	for (SDL_Surface* surface : surfaces)
+	{
+		SDL_FreeSurface(surface);
+	}
+}
+
+// A headless game with the autopilot a few seconds in: saving and loading its full state, and the rewind ring the game
+// keeps them in. Needs the game's assets, so run it from the repository root.
+static void BenchSnapshot()
+{
+	setenv("SDL_VIDEODRIVER", "dummy", 0);
+	setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+	Options options;
+	options.headless = true;
+	options.cpu_raster = true;
+	options.no_music = true;
+	options.autopilot = true;
+	options.auto_reset = true;
+	options.seed = 1;
+	options.fixed_seed = true;
+
+	Game game(options);
+
+	for (int tick = 0; tick < 5 * constants::tick_rate; ++tick)
+	{
+		game.Tick();
+	}
+
+	const int repeats = 1000000;
+	Snapshot snapshot;
+
+	BenchClock::time_point start = BenchClock::now();
+
+	for (int r = 0; r < repeats; ++r)
+	{
+		game.SaveSnapshot(snapshot);
+		sink = sink + snapshot.tick_count;
+	}
+
+	const double save_ns = NanosecondsPer(start, repeats);
+
+	start = BenchClock::now();
+
+	for (int r = 0; r < repeats; ++r)
+	{
+		game.LoadSnapshot(snapshot);
+	}
+
+	const double load_ns = NanosecondsPer(start, repeats);
+
+	start = BenchClock::now();
+
+	for (int r = 0; r < repeats; ++r)
+	{
+		sink = sink + snapshot.Checksum();
+	}
+
+	const double checksum_ns = NanosecondsPer(start, repeats);
+
+	// The game's own ring: ten seconds of ticks, each pushing one snapshot, and the one-second rewind of Backspace.
+	SnapshotRing ring(constants::rewind_seconds * constants::tick_rate);
+	const int rounds = repeats / constants::tick_rate;
+	double push_ns = 0.0;
+	double rewind_ns = 0.0;
+
+	for (int r = 0; r < rounds; ++r)
+	{
+		start = BenchClock::now();
+
+		for (int tick = 0; tick < constants::tick_rate; ++tick)
+		{
+			game.SaveSnapshot(ring.Push());
+		}
+
+		push_ns += NanosecondsPer(start, static_cast<double>(rounds) * constants::tick_rate);
+
+		start = BenchClock::now();
+		game.LoadSnapshot(*ring.Rewind(constants::tick_rate));
+		rewind_ns += NanosecondsPer(start, rounds);
+	}
+
+	printf("%s\n", "snapshot: ns per operation");
+	printf("save %.1f, load %.1f, checksum %.1f, ring push and save %.1f, one-second rewind and load %.1f (%zu byte snapshots)\n", save_ns, load_ns, checksum_ns, push_ns, rewind_ns, sizeof(Snapshot));
+}
+
+// The game's counter-based streams against std::mt19937_64, raw and through uniform_int_distribution for the 0-3
+// picks the spawners make. Then every (seed, stream, index) value is drawn again with the streams taken in another
+// order, which must not change a single value.
+static void BenchRandom()
+{
+	const int draws = 10000000;
+	RandomStream stream = RandomStream::Create(1, RandomSubsystem::OBSTACLES, 0);
+	std::mt19937_64 engine(1);
+	std::uniform_int_distribution<int> distribution(0, 3);
+	std::uint64_t total = 0;
+
+	BenchClock::time_point start = BenchClock::now();
+
+	for (int i = 0; i < draws; ++i)
+	{
+		total += stream.Next();
+	}
+
+	const double next_ns = NanosecondsPer(start, draws);
+
+	start = BenchClock::now();
+
+	for (int i = 0; i < draws; ++i)
+	{
+		total += stream.Below(4);
+	}
+
+	const double below_ns = NanosecondsPer(start, draws);
+
+	start = BenchClock::now();
+
+	for (int i = 0; i < draws; ++i)
+	{
+		total += engine();
+	}
+
+	const double engine_ns = NanosecondsPer(start, draws);
+
+	start = BenchClock::now();
+
+	for (int i = 0; i < draws; ++i)
+	{
+		total += distribution(engine);
+	}
+
+	const double distribution_ns = NanosecondsPer(start, draws);
+	sink = sink + total;
+
+	printf("%s\n", "random: ns per value");
+	printf("RandomStream Next %.2f, Below(4) %.2f; mt19937_64 %.2f, with uniform_int_distribution(0, 3) %.2f\n", next_ns, below_ns, engine_ns, distribution_ns);
+
+	// Every stream the game creates for two seeds, drawn one stream after another, then round robin from the last
+	// stream back to the first.
+	constexpr int values_per_stream = 1000;
+	const RandomSubsystem subsystems[] = { RandomSubsystem::OBSTACLES, RandomSubsystem::BONUS_ITEMS, RandomSubsystem::PARTICLES };
+	std::vector<RandomStream> in_order;
+
+	for (const std::uint64_t seed : { 1, 2 })
+	{
+		for (const RandomSubsystem subsystem : subsystems)
+		{
+			for (std::uint32_t index = 0; index < 8; ++index)
+			{
+				in_order.push_back(RandomStream::Create(seed, subsystem, index));
+			}
+		}
+	}
+
+	std::vector<RandomStream> interleaved = in_order;
+	std::vector<std::uint64_t> sequential_values(in_order.size() * values_per_stream);
+	std::vector<std::uint64_t> interleaved_values(in_order.size() * values_per_stream);
+
+	for (std::size_t s = 0; s < in_order.size(); ++s)
+	{
+		for (int i = 0; i < values_per_stream; ++i)
+		{
+			sequential_values[s * values_per_stream + i] = in_order[s].Next();
+		}
+	}
+
+	for (int i = 0; i < values_per_stream; ++i)
+	{
+		for (std::size_t s = interleaved.size(); s-- > 0;)
+		{
+			interleaved_values[s * values_per_stream + i] = interleaved[s].Next();
+		}
+	}
+
+	std::size_t mismatches = 0;
+	std::size_t random_access_mismatches = 0;
+
+	for (std::size_t s = 0; s < in_order.size(); ++s)
+	{
+		for (int i = 0; i < values_per_stream; ++i)
+		{
+			const std::uint64_t value = sequential_values[s * values_per_stream + i];
+			mismatches += value != interleaved_values[s * values_per_stream + i];
+			random_access_mismatches += value != RandomStream::At(in_order[s].key, i);
+		}
+	}
+
+	printf("%zu streams x %d values drawn in two orders: %zu differ, %zu differ from RandomStream::At\n", in_order.size(), values_per_stream, mismatches, random_access_mismatches);
+}
+
+struct Benchmark
+{
+	const char* name;
+	void (*run)();
+};
+
+static const Benchmark benchmarks[] = {
+	{ "rects", BenchRects },
+	{ "masks", BenchMasks },
+	{ "particles", BenchParticles },
+	{ "raster", BenchRaster },
+	{ "snapshot", BenchSnapshot },
+	{ "random", BenchRandom },
+};
+
+int main(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+
+		for (const Benchmark& benchmark : benchmarks)
+		{
+			known = known || std::strcmp(argv[i], benchmark.name) == 0;
+		}
+
+		if (!known)
+		{
+			printf("Unknown benchmark: %s\n", argv[i]);
+			printf("Usage: %s [", argv[0]);
+
+			for (const Benchmark& benchmark : benchmarks)
+			{
+				printf(" %s", benchmark.name);
+			}
+
+			printf(" ]\n");
+			return 1;
+		}
+	}
+
+	for (const Benchmark& benchmark : benchmarks)
+	{
+		bool selected = argc == 1;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+		}
+
+		if (selected)
+		{
+			benchmark.run();
+		}
+	}
+
+	return 0;
+}
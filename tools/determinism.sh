@@ -0,0 +1,41 @@
+#!/bin/sh
+# Builds the game at -O0 and -O3 through the Makefile, each with its own object directory, plays the same unattended
+# game with both and compares the checksums of the final simulation state. Run from the repository root, the game
+# loads its assets from res/.
+#
+#   tools/determinism.sh [TICKS] [VARIABLE=VALUE ...]
+#
+# Every VARIABLE=VALUE is passed on to make, e.g. CXX=g++. BUILD_DIR picks where the two builds go (default
+# /tmp/sidescroller-determinism).
+
+set -e
+
+ticks=${1:-1000000}
+[ $# -gt 0 ] && shift
+build_dir=${BUILD_DIR:-/tmp/sidescroller-determinism}
+jobs=$(nproc 2>/dev/null || echo 4)
+
+for level in O0 O3; do
+	dir="$build_dir/$level"
+	echo "Building -$level in $dir"
+
+	# The Makefile's flags with only the optimization level changed.
+	make -j"$jobs" "$@" CXXFLAGS="-std=c++17 -$level -Wall -Wextra -pedantic -pthread" OBJ_DIR="$dir/obj" TARGET="$dir/output" "$dir/output"
+
+	echo "Running $ticks ticks with -$level"
+	SDL_VIDEODRIVER=dummy SDL_AUDIODRIVER=dummy "$dir/output" --headless --no-music --autopilot --auto-reset --seed 1 --ticks-per-frame 1000 --exit-after-ticks "$ticks" > "$dir/run.log"
+
+	if ! grep "^Checksum after" "$dir/run.log" > "$dir/checksum"; then
+		echo "The -$level build printed no checksum, see $dir/run.log"
+		exit 1
+	fi
+
+	cat "$dir/checksum"
+done
+
+if diff "$build_dir/O0/checksum" "$build_dir/O3/checksum" > /dev/null; then
+	echo "Checksums match."
+else
+	echo "Checksums differ! Rerun both builds with --checksum-log FILE and diff the logs to find the first tick that diverges."
+	exit 1
+fi
@@ -0,0 +1,71 @@
+#include "MetricsExport.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Prints the live metrics a running game publishes with --metrics-shm, twice a second. Stops when the frame has not
+// advanced for two seconds, since an exited game's last sample stays readable through the mapping.
+int main(int argc, char* argv[])
+{
+	std::string name = "/sidescroller";
+	bool once = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--once") == 0)
+		{
+			once = true;
+		}
+		else
+		{
+			name = argv[i];
+		}
+	}
+
+	const SharedMetrics* shared = MetricsExport::Attach(name);
+
+	if (shared == nullptr)
+	{
+		printf("No game is publishing metrics at %s!\n", name.c_str());
+		return 1;
+	}
+
+	printf("%10s %7s %7s %8s %8s %8s %5s %5s %9s %6s %7s %6s %5s %7s %6s %5s\n", "frame", "fps", "ticks/s", "p50 ms", "p95 ms", "p99 ms", "obst", "bonus", "particles", "draws", "allocs", "surfs", "texs", "score", "speed", "over");
+
+	const int polls_per_second = 2;
+	const int stale_seconds = 2;
+
+	MetricsSample sample;
+	std::uint64_t last_frame = ~0ull;
+	int stale_polls = 0;
+
+	do
+	{
+		if (!MetricsExport::Read(*shared, sample))
+		{
+			printf("%s\n", "Metrics are being rewritten too fast to read, retrying.");
+		}
+		else if (sample.frame != last_frame)
+		{
+			last_frame = sample.frame;
+			stale_polls = 0;
+			printf("%10llu %7.1f %7.1f %8.3f %8.3f %8.3f %5u %5u %9u %6u %7u %6u %5u %7d %6d %5s\n", static_cast<unsigned long long>(sample.frame), sample.fps, sample.tick_rate, sample.frame_ms_p50, sample.frame_ms_p95, sample.frame_ms_p99, sample.obstacles, sample.bonus_items, sample.particles, sample.draw_calls, sample.allocations, sample.surfaces, sample.textures, sample.score, sample.scrolling_speed, sample.game_over ? "yes" : "no");
+		}
+		else if (!once && ++stale_polls == polls_per_second * stale_seconds)
+		{
+			printf("No new frame at %s for %d seconds, the game has exited or hung!\n", name.c_str(), stale_seconds);
+			return 1;
+		}
+
+		if (!once)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1000 / polls_per_second));
+		}
+	}
+	while (!once);
+
+	return 0;
+}